@@ -3,7 +3,55 @@
 #include "projectlistmodel.h"
 
 ProjectListModel::ProjectListModel(TomControl *control, QObject *parent) : QAbstractListModel(parent), _control(control) {
-    _projects = _control->loadProjects();
+    _matcher.reset(_control->cachedProjects());
+    _recentProjectIDs = recentProjectIDs();
+    _matcher.setRecentProjectIDs(_recentProjectIDs);
+
+    connect(_control, &TomControl::projectCreated, this, &ProjectListModel::reload);
+    connect(_control, &TomControl::projectUpdated, this, &ProjectListModel::reload);
+    connect(_control, &TomControl::projectRemoved, this, &ProjectListModel::reload);
+    connect(_control, &TomControl::projectHierarchyChanged, this, &ProjectListModel::reload);
+    connect(_control, &TomControl::projectsCached, this, &ProjectListModel::reload);
+    connect(_control->recentProjects(), &RecentProjects::changed, this, &ProjectListModel::updateRecentProjects);
+}
+
+void ProjectListModel::reload() {
+    // the boosts of the recent projects are reset with the projects
+    _matcher.reset(_control->cachedProjects());
+    _recentProjectIDs = recentProjectIDs();
+    _matcher.setRecentProjectIDs(_recentProjectIDs);
+    setQuery(_query);
+}
+
+void ProjectListModel::setQuery(const QString &query) {
+    _query = query;
+
+    beginResetModel();
+    _projects.clear();
+    for (const auto &match : _matcher.match(query)) {
+        const Project &project = _control->cachedProject(match.projectID);
+        if (project.isValid()) {
+            _projects << project;
+        }
+    }
+    endResetModel();
+}
+
+void ProjectListModel::updateRecentProjects() {
+    const QStringList &ids = recentProjectIDs();
+    if (ids != _recentProjectIDs) {
+        _recentProjectIDs = ids;
+        _matcher.setRecentProjectIDs(ids);
+        setQuery(_query);
+    }
+}
+
+QStringList ProjectListModel::recentProjectIDs() const {
+    QStringList ids;
+    for (const auto &project : _control->cachedRecentProjects()) {
+        ids << project.getID();
+    }
+    return ids;
 }
 
 QVariant ProjectListModel::data(const QModelIndex &index, int role) const {
@@ -4,7 +4,12 @@
 #include <QtCore/QAbstractListModel>
 
 #include "source/gotime/TomControl.h"
+#include "source/model/ProjectMatcher.h"
 
+/**
+ * Flat list of the projects cached by the control matching a query, ordered by relevance.
+ * It's kept up-to-date without calling tom.
+ */
 class ProjectListModel : public QAbstractListModel {
 Q_OBJECT
 
@@ -15,8 +20,25 @@ public:
 
     int rowCount(const QModelIndex &parent) const override;
 
+    /**
+     * Displays the best matches of the query, no projects are displayed for an empty query.
+     */
+    void setQuery(const QString &query);
+
+private slots:
+
+    void reload();
+
+    void updateRecentProjects();
+
 private:
+    QStringList recentProjectIDs() const;
+
     TomControl *_control;
+    ProjectMatcher _matcher;
+    QStringList _recentProjectIDs;
+    QString _query;
+    // the matching projects
     QList<Project> _projects;
 };
 
@@ -10,22 +10,30 @@
 ProjectTreeComboBox::ProjectTreeComboBox(QWidget *parent) : QComboBox(parent),
                                                             _skipNextHide(false),
                                                             _control(nullptr),
-                                                            _sourceModel(nullptr),
-                                                            _sortModel(nullptr) {
+                                                            _sortModel(nullptr),
+                                                            _view(nullptr) {
 }
 
 void ProjectTreeComboBox::setup(TomControl *control, ProjectStatusManager *statusManager, const QList<Project> &hiddenProjects) {
     setFocusPolicy(Qt::StrongFocus);
 
-    _control = control;
-    _sourceModel = new ProjectTreeModel(control, statusManager, true, this, false, false);
-    _sourceModel->loadProjects();
+    QSet<QString> hiddenIDs;
     for (const auto &p: hiddenProjects) {
-        _sourceModel->removeProject(p);
+        hiddenIDs << p.getID();
+    }
+
+    // the dialogs call setup() again when they're reset
+    if (_sortModel) {
+        _sortModel->setHiddenProjectIDs(hiddenIDs);
+        return;
     }
 
-    _sortModel = new QSortFilterProxyModel(this);
-    _sortModel->setSourceModel(_sourceModel);
+    _control = control;
+    _sourceModel = ProjectTreeModel::shared(control, statusManager);
+
+    _sortModel = new ProjectTreeSortFilterModel(this);
+    _sortModel->setSourceModel(_sourceModel.data());
+    _sortModel->setHiddenProjectIDs(hiddenIDs);
     _sortModel->sort(ProjectTreeItem::COL_NAME, Qt::AscendingOrder);
     setModel(_sortModel);
 
@@ -1,6 +1,7 @@
 #ifndef TOM_UI_CHECKBOXCOMBOBOX_H
 #define TOM_UI_CHECKBOXCOMBOBOX_H
 
+#include <QtCore/QSharedPointer>
 #include <QtWidgets/QComboBox>
 #include <source/view/ProjectTreeView.h>
 
@@ -9,6 +10,11 @@ Q_OBJECT
 public:
     explicit ProjectTreeComboBox(QWidget *parent);
 
+    /**
+     * Attaches the combo box to the shared project model. It may be called again to update the hidden projects,
+     * the model and the view are only created once.
+     * @param hiddenProjects These projects and their subprojects are not displayed.
+     */
     void setup(TomControl *control, ProjectStatusManager *statusManager, const QList<Project> &hiddenProjects = QList<Project>());
 
     bool eventFilter(QObject *watched, QEvent *event) override;
@@ -29,8 +35,8 @@ signals:
 
 private:
     TomControl *_control;
-    ProjectTreeModel *_sourceModel;
-    QSortFilterProxyModel *_sortModel;
+    QSharedPointer<ProjectTreeModel> _sourceModel;
+    ProjectTreeSortFilterModel *_sortModel;
     ProjectTreeView *_view;
 };
 
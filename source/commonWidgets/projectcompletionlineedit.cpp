@@ -18,14 +18,18 @@ void ProjectCompletionLineEdit::setup(TomControl *control) {
 
     _control = control;
 
+    // the model contains the ranked matches of the text, the completer displays them unfiltered
     auto *model = new ProjectListModel(control, this);
     auto *completer = new QCompleter(model, this);
-    completer->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setModelSorting(QCompleter::UnsortedModel);
     completer->setCaseSensitivity(Qt::CaseInsensitive);
     completer->setWrapAround(true);
     completer->setMaxVisibleItems(15);
     completer->setCompletionRole(Qt::DisplayRole);
-    completer->setFilterMode(Qt::MatchContains);
+
+    // the line edit updates the popup after textEdited() was emitted
+    connect(this, &QLineEdit::textEdited, model, &ProjectListModel::setQuery);
 
     setCompleter(completer);
     connect(completer, QOverload<const QModelIndex &>::of(&QCompleter::activated), this, &ProjectCompletionLineEdit::onProjectSelected);
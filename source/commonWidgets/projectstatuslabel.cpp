@@ -1,6 +1,6 @@
 #include "projectstatuslabel.h"
 
-ProjectStatusLabel::ProjectStatusLabel(QWidget *parent) : QLabel(parent), _control(nullptr) {
+ProjectStatusLabel::ProjectStatusLabel(QWidget *parent) : QLabel(parent), _control(nullptr), _updateTask(0) {
     setText("");
 }
 
@@ -12,11 +12,25 @@ void ProjectStatusLabel::setup(TomControl *control) {
 
     updateStatus();
 
-    auto *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, [this] {
+    // the label is part of dialogs which are shown without the main window, it's only refreshed while it's visible
+    _updateTask = _control->scheduler()->addTask("status label", 1000, RefreshScheduler::BackgroundTask, this, [this] {
         updateStatus();
-    });
-    timer->start(1000);
+    }, isVisible());
+}
+
+void ProjectStatusLabel::showEvent(QShowEvent *event) {
+    QLabel::showEvent(event);
+    if (_control) {
+        updateStatus();
+        _control->scheduler()->setTaskEnabled(_updateTask, true);
+    }
+}
+
+void ProjectStatusLabel::hideEvent(QHideEvent *event) {
+    QLabel::hideEvent(event);
+    if (_control) {
+        _control->scheduler()->setTaskEnabled(_updateTask, false);
+    }
 }
 
 void ProjectStatusLabel::updateStatus() {
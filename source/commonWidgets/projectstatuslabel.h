@@ -13,10 +13,16 @@ public:
 
     void setup(TomControl *control);
 
+protected:
+    void showEvent(QShowEvent *event) override;
+
+    void hideEvent(QHideEvent *event) override;
+
 private:
     void updateStatus();
 
     TomControl *_control;
+    int _updateTask;
 };
 
 
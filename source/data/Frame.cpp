@@ -24,3 +24,13 @@ Frame::Frame(QString id,
 const Timespan Frame::getDuration() const {
     return Timespan::of(startTime, stopTime);
 }
+
+QDataStream &operator<<(QDataStream &out, const Frame &frame) {
+    return out << frame.id << frame.projectID << frame.startTime << frame.stopTime << frame.lastUpdated
+               << frame.notes << frame.tags << frame.archived;
+}
+
+QDataStream &operator>>(QDataStream &in, Frame &frame) {
+    return in >> frame.id >> frame.projectID >> frame.startTime >> frame.stopTime >> frame.lastUpdated
+              >> frame.notes >> frame.tags >> frame.archived;
+}
@@ -1,6 +1,7 @@
 #ifndef GOTIME_UI_FRAME_H
 #define GOTIME_UI_FRAME_H
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include <timespan/timespan.h>
 
@@ -43,5 +44,8 @@ public:
     }
 };
 
+QDataStream &operator<<(QDataStream &out, const Frame &frame);
+
+QDataStream &operator>>(QDataStream &in, Frame &frame);
 
 #endif //GOTIME_UI_FRAME_H
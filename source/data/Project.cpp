@@ -78,3 +78,19 @@ bool Project::appliedIsNoteRequired() const {
     return _noteRequiredApplied;
 }
 
+QDataStream &operator<<(QDataStream &out, const Project &project) {
+    return out << project._id << project._parentID << project._names << project._hourlyRate
+               << qint8(project._noteRequired) << project._noteRequiredApplied << project._lastUpdated
+               << project._isValid << project._isRootProject;
+}
+
+QDataStream &operator>>(QDataStream &in, Project &project) {
+    qint8 noteRequired = UNDEFINED;
+    in >> project._id >> project._parentID >> project._names >> project._hourlyRate
+       >> noteRequired >> project._noteRequiredApplied >> project._lastUpdated
+       >> project._isValid >> project._isRootProject;
+
+    project._noteRequired = static_cast<TriState>(noteRequired);
+    project._fullName = project._names.join("/");
+    return in;
+}
@@ -40,6 +40,10 @@ public:
         return root;
     }
 
+    friend QDataStream &operator<<(QDataStream &out, const Project &project);
+
+    friend QDataStream &operator>>(QDataStream &in, Project &project);
+
 private:
     QString _id;
     QString _parentID;
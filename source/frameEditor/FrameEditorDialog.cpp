@@ -1,24 +1,28 @@
+#include <algorithm>
+
 #include <QDateTimeEdit>
 #include <QPushButton>
+#include <QMessageBox>
 
 #include "FrameEditorDialog.h"
 
-FrameEditorDialog::FrameEditorDialog(const Frame &frame, TomControl *control, ProjectStatusManager *statusManager, QWidget *parent) : QDialog(parent), Ui::FrameDialog(),
-                                                                                                                                      _frame(frame),
-                                                                                                                                      _control(control),
-                                                                                                                                      _statusManager(statusManager) {
+FrameEditorDialog::FrameEditorDialog(const Frame &frame, TomControl *control, ProjectStatusManager *statusManager, const FrameIntervalIndex *intervals, QWidget *parent)
+        : QDialog(parent), Ui::FrameDialog(),
+          _frame(frame),
+          _control(control),
+          _statusManager(statusManager),
+          _intervals(intervals) {
 
     setupUi(this);
     setModal(true);
     setWindowTitle(tr("Edit Time Entry"));
     loadFrame(frame);
 
-    connect(_buttonBox, &QDialogButtonBox::accepted, this, &FrameEditorDialog::saveFrame);
     connect(_buttonBox->button(QDialogButtonBox::Reset), &QPushButton::clicked, [this] { loadFrame(_frame); });
 }
 
-void FrameEditorDialog::show(const Frame &frame, TomControl *control, ProjectStatusManager *statusManager, QWidget *parent) {
-    auto *dialog = new FrameEditorDialog(frame, control, statusManager, parent);
+void FrameEditorDialog::show(const Frame &frame, TomControl *control, ProjectStatusManager *statusManager, const FrameIntervalIndex *intervals, QWidget *parent) {
+    auto *dialog = new FrameEditorDialog(frame, control, statusManager, intervals, parent);
     dialog->showNormal();
 }
 
@@ -50,13 +54,63 @@ void FrameEditorDialog::loadFrame(const Frame &frame) {
     _notesEdit->setPlainText(frame.notes);
 }
 
-void FrameEditorDialog::saveFrame() {
+void FrameEditorDialog::accept() {
+    // the dialog stays open if the user doesn't want to save an overlapping entry
+    if (saveFrame()) {
+        QDialog::accept();
+    }
+}
+
+bool FrameEditorDialog::saveFrame() {
+    if (!confirmOverlap()) {
+        return false;
+    }
+
     const QString &projectID = _projectBox->selectedProject().getID();
 
-    _control->updateFrames(QStringList() << _frame.id, QStringList() << projectID,
+    return _control->updateFrames(QStringList() << _frame.id, QStringList() << projectID,
                            true, _beginEdit->dateTime(),
                            true, _endEdit->dateTime(),
                            true, _notesEdit->toPlainText(),
                            true, projectID,
                            true, _archivedCheckBox->isChecked());
 }
+
+bool FrameEditorDialog::confirmOverlap() {
+    // active entries don't have an end, the edit field is showing the current time
+    const QDateTime &begin = _beginEdit->dateTime();
+    const QDateTime &end = _frame.stopTime.isValid() ? _endEdit->dateTime() : QDateTime();
+
+    // entries of other projects are double-booked, too
+    const FrameStore *store = _statusManager ? _statusManager->frameStore() : nullptr;
+    const FrameIntervalIndex *intervals = store && store->isLoaded() ? &store->intervalIndex() : _intervals;
+
+    QList<Frame> overlapping;
+    if (intervals) {
+        for (auto *frame : intervals->overlapping(begin, end)) {
+            if (frame->id != _frame.id) {
+                overlapping << *frame;
+            }
+        }
+    }
+
+    if (overlapping.isEmpty()) {
+        return true;
+    }
+
+    std::sort(overlapping.begin(), overlapping.end(), [](const Frame &a, const Frame &b) {
+        return a.startTime < b.startTime;
+    });
+
+    QStringList entries;
+    for (auto frame : overlapping.mid(0, 5)) {
+        entries << QString("%1 - %2, %3")
+                .arg(frame.startTime.toString(Qt::SystemLocaleShortDate))
+                .arg(frame.isActive() ? tr("now") : frame.stopTime.toString(Qt::SystemLocaleShortDate))
+                .arg(_control->cachedProject(frame.projectID).getName());
+    }
+
+    const QString &message = tr("The time entry overlaps with %n other entries:", "", overlapping.size()) + "\n\n" + entries.join("\n")
+                             + "\n\n" + tr("Do you want to save it anyway?");
+    return QMessageBox::question(this, tr("Overlapping Time Entries"), message) == QMessageBox::Yes;
+}
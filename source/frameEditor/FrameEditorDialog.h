@@ -6,23 +6,33 @@
 #include "ui_frame_dialog.h"
 #include "source/gotime/TomControl.h"
 #include "source/gotime/ProjectStatusManager.h"
+#include "source/model/FrameIntervalIndex.h"
 
 class FrameEditorDialog : public QDialog, private Ui::FrameDialog {
     Q_OBJECT
 
 public:
-    FrameEditorDialog(const Frame &frame, TomControl *control, ProjectStatusManager* statusManager, QWidget *parent);
+    /**
+     * @param intervals The index of the time entries shown in the UI. It's used to warn about overlapping entries
+     *      until the frames of all projects are available. May be null.
+     */
+    FrameEditorDialog(const Frame &frame, TomControl *control, ProjectStatusManager* statusManager, const FrameIntervalIndex *intervals, QWidget *parent);
 
-    static void show(const Frame &frame, TomControl *control, ProjectStatusManager* statusManager, QWidget *parent);
+    static void show(const Frame &frame, TomControl *control, ProjectStatusManager* statusManager, const FrameIntervalIndex *intervals, QWidget *parent);
 
-private slots:
+public slots:
 
-    void saveFrame();
+    void accept() override;
 
 private:
     Frame _frame;
     TomControl *_control;
     ProjectStatusManager* _statusManager;
+    const FrameIntervalIndex *_intervals;
+
+    bool saveFrame();
+
+    bool confirmOverlap();
 
     void loadFrame(const Frame& frame);
 };
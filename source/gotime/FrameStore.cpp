@@ -0,0 +1,223 @@
+#include <QtConcurrent/QtConcurrent>
+
+#include "FrameStore.h"
+
+FrameStore::FrameStore(TomControl *control, QObject *parent) : QObject(parent),
+                                                               _control(control),
+                                                               _loaded(false),
+                                                               _reload(new QFutureWatcher<LoadedFrames>(this)),
+                                                               _reloadOutdated(false),
+                                                               _reloadCancelled(0) {
+    connect(_reload, &QFutureWatcher<LoadedFrames>::finished, this, &FrameStore::onReloadFinished);
+
+    connect(_control, &TomControl::frameTimesUpdated, this, &FrameStore::onFrameTimesUpdated);
+    connect(_control, &TomControl::framesRemoved, this, &FrameStore::onFramesRemoved);
+    connect(_control, &TomControl::framesMoved, this, &FrameStore::onFramesMoved);
+    connect(_control, &TomControl::framesArchived, this, &FrameStore::onFramesArchived);
+    connect(_control, &TomControl::projectFramesArchived, this, &FrameStore::onProjectFramesArchived);
+    connect(_control, &TomControl::projectStatusChanged, this, &FrameStore::onProjectStatusChanged);
+
+    // the frames of removed projects are removed by tom, too
+    connect(_control, &TomControl::projectRemoved, this, &FrameStore::reload);
+    connect(_control, &TomControl::dataResetNeeded, this, &FrameStore::reload);
+}
+
+FrameStore::~FrameStore() {
+    if (_reload->isRunning()) {
+        _reloadCancelled.storeRelease(1);
+        _reload->waitForFinished();
+        qDeleteAll(_reload->result().frames);
+    }
+    qDeleteAll(_frames);
+}
+
+bool FrameStore::isLoaded() const {
+    return _loaded;
+}
+
+const QHash<QString, Frame *> &FrameStore::frames() const {
+    return _frames;
+}
+
+const QSet<Frame *> &FrameStore::activeFrames() const {
+    return _activeFrames;
+}
+
+const FrameIntervalIndex &FrameStore::intervalIndex() const {
+    return _intervals;
+}
+
+void FrameStore::reload() {
+    if (_reload->isRunning()) {
+        _reloadOutdated = true;
+        return;
+    }
+    _reloadOutdated = false;
+
+    // streamFrames() doesn't access the state of the control
+    const TomControl *control = _control;
+    QAtomicInt *cancelled = &_reloadCancelled;
+    _reload->setFuture(QtConcurrent::run([control, cancelled] {
+        LoadedFrames loaded;
+        loaded.complete = control->streamFrames("", true, true, [&loaded, cancelled](Frame &frame) {
+            if (cancelled->loadAcquire()) {
+                return false;
+            }
+            loaded.frames.insert(frame.id, copyFrame(frame));
+            return true;
+        });
+        return loaded;
+    }));
+}
+
+void FrameStore::setFrames(const QList<Frame *> &frames) {
+    QHash<QString, Frame *> copies;
+    copies.reserve(frames.size());
+    for (auto *frame : frames) {
+        copies.insert(frame->id, copyFrame(*frame));
+    }
+    applyFrames(copies);
+}
+
+void FrameStore::onReloadFinished() {
+    const LoadedFrames &loaded = _reload->result();
+    if (!loaded.complete) {
+        // the current frames are kept if tom's frames couldn't be loaded
+        qDeleteAll(loaded.frames);
+        return;
+    }
+
+    applyFrames(loaded.frames);
+    if (_reloadOutdated) {
+        reload();
+    }
+}
+
+void FrameStore::onFrameTimesUpdated(const QStringList &frameIDs, const QDateTime &start, const QDateTime &end) {
+    for (const auto &id : frameIDs) {
+        Frame *frame = _frames.value(id);
+        if (frame) {
+            removeFrame(frame);
+            if (start.isValid()) {
+                frame->startTime = start;
+            }
+            if (end.isValid()) {
+                frame->stopTime = end;
+            }
+            addFrame(frame);
+        }
+    }
+    frameDataChanged();
+}
+
+void FrameStore::onFramesRemoved(const QStringList &frameIDs) {
+    for (const auto &id : frameIDs) {
+        Frame *frame = _frames.value(id);
+        if (frame) {
+            removeFrame(frame);
+            delete frame;
+        }
+    }
+    frameDataChanged();
+}
+
+void FrameStore::onFramesMoved(const QStringList &frameIDs, const QStringList &, const QString &newProjectID) {
+    for (const auto &id : frameIDs) {
+        Frame *frame = _frames.value(id);
+        if (frame) {
+            removeFrame(frame);
+            frame->projectID = newProjectID;
+            addFrame(frame);
+        }
+    }
+    frameDataChanged();
+}
+
+void FrameStore::onFramesArchived(const QStringList &frameIDs, const QStringList &, bool nowArchived) {
+    for (const auto &id : frameIDs) {
+        Frame *frame = _frames.value(id);
+        if (frame) {
+            removeFrame(frame);
+            frame->archived = nowArchived;
+            addFrame(frame);
+        }
+    }
+    frameDataChanged();
+}
+
+void FrameStore::onProjectFramesArchived(const QStringList &projectIDs) {
+    for (const auto &projectID : projectIDs) {
+        for (auto *frame : _framesByProject.value(projectID)) {
+            removeFrame(frame);
+            frame->archived = true;
+            addFrame(frame);
+        }
+    }
+    frameDataChanged();
+}
+
+void FrameStore::onProjectStatusChanged(const Project &, const Project &) {
+    const TomStatus &status = _control->cachedStatus();
+    const QString &activeID = status.isValid ? status.timeEntryId() : QString();
+
+    // the status doesn't contain the end of the stopped frame, it was stopped just now
+    const QDateTime &now = QDateTime::currentDateTime();
+    for (auto *frame : _activeFrames.toList()) {
+        if (frame->id != activeID) {
+            removeFrame(frame);
+            frame->stopTime = qMax(now, frame->startTime);
+            addFrame(frame);
+        }
+    }
+
+    if (!activeID.isEmpty() && !_frames.contains(activeID)) {
+        addFrame(new Frame(activeID, status.currentProject().getID(), status.startTime(), QDateTime(), QDateTime(), "", QStringList(), false));
+    }
+    frameDataChanged();
+}
+
+Frame *FrameStore::copyFrame(const Frame &frame) {
+    // the notes and tags aren't needed for the totals
+    return new Frame(frame.id, frame.projectID, frame.startTime, frame.stopTime, frame.lastUpdated, "", QStringList(), frame.archived);
+}
+
+void FrameStore::applyFrames(const QHash<QString, Frame *> &frames) {
+    qDeleteAll(_frames);
+    _frames = frames;
+    _framesByProject.clear();
+    _activeFrames.clear();
+    for (auto *frame : _frames) {
+        _framesByProject[frame->projectID].insert(frame);
+        if (frame->isActive()) {
+            _activeFrames.insert(frame);
+        }
+    }
+    _intervals.reset(_frames.values());
+
+    _loaded = true;
+    emit framesReset();
+    emit changed();
+}
+
+void FrameStore::addFrame(Frame *frame) {
+    _frames.insert(frame->id, frame);
+    _framesByProject[frame->projectID].insert(frame);
+    if (frame->isActive()) {
+        _activeFrames.insert(frame);
+    }
+    _intervals.insert(frame);
+    emit frameAdded(frame);
+}
+
+void FrameStore::removeFrame(Frame *frame) {
+    emit frameRemoved(frame);
+    _frames.remove(frame->id);
+    _framesByProject[frame->projectID].remove(frame);
+    _activeFrames.remove(frame);
+    _intervals.remove(frame);
+}
+
+void FrameStore::frameDataChanged() {
+    _reloadOutdated |= _reload->isRunning();
+    emit changed();
+}
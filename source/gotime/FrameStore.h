@@ -0,0 +1,130 @@
+#ifndef TOM_UI_FRAMESTORE_H
+#define TOM_UI_FRAMESTORE_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+
+#include "TomControl.h"
+#include "model/FrameIntervalIndex.h"
+
+/**
+ * All frames of tom including the archived ones, without notes and tags. The frames are loaded once, from the frames
+ * loaded at startup or from tom in the background, and the modifications made by the application are applied locally.
+ * The store is shared by the computed project status, the rollup of the reports and the overlap check of the frame
+ * editor. The status and the rollup keep their totals up-to-date with frameRemoved() and frameAdded().
+ * A modification removes the previous values and adds the new values.
+ */
+class FrameStore : public QObject {
+Q_OBJECT
+
+public:
+    FrameStore(TomControl *control, QObject *parent);
+
+    ~FrameStore() override;
+
+    /**
+     * @return true if the frames were loaded completely.
+     */
+    bool isLoaded() const;
+
+    /**
+     * @return The frames by ID.
+     */
+    const QHash<QString, Frame *> &frames() const;
+
+    /**
+     * @return The active frames, which are growing until they're stopped.
+     */
+    const QSet<Frame *> &activeFrames() const;
+
+    /**
+     * @return The interval index of the frames of all projects, e.g. to find double-booked time.
+     */
+    const FrameIntervalIndex &intervalIndex() const;
+
+public slots:
+
+    /**
+     * Loads all frames from tom in the background and replaces the frames when all frames were loaded.
+     */
+    void reload();
+
+    /**
+     * Replaces the frames with copies of the given frames, which must be all frames including the archived ones.
+     */
+    void setFrames(const QList<Frame *> &frames);
+
+signals:
+
+    /**
+     * Emitted when all frames were replaced.
+     */
+    void framesReset();
+
+    /**
+     * Emitted with the previous values before a frame is modified or removed.
+     */
+    void frameRemoved(const Frame *frame);
+
+    /**
+     * Emitted after a frame was added or modified.
+     */
+    void frameAdded(const Frame *frame);
+
+    /**
+     * Emitted after the frames were replaced or modified.
+     */
+    void changed();
+
+private slots:
+
+    void onFrameTimesUpdated(const QStringList &frameIDs, const QDateTime &start, const QDateTime &end);
+
+    void onFramesRemoved(const QStringList &frameIDs);
+
+    void onFramesMoved(const QStringList &frameIDs, const QStringList &oldProjectIDs, const QString &newProjectID);
+
+    void onFramesArchived(const QStringList &frameIDs, const QStringList &projectIDs, bool nowArchived);
+
+    void onProjectFramesArchived(const QStringList &projectIDs);
+
+    void onProjectStatusChanged(const Project &started, const Project &stopped);
+
+    void onReloadFinished();
+
+private:
+    struct LoadedFrames {
+        QHash<QString, Frame *> frames;
+        // false if tom failed, its output was truncated or the load was cancelled
+        bool complete = false;
+    };
+
+    static Frame *copyFrame(const Frame &frame);
+
+    void applyFrames(const QHash<QString, Frame *> &frames);
+
+    void addFrame(Frame *frame);
+
+    void removeFrame(Frame *frame);
+
+    void frameDataChanged();
+
+    TomControl *_control;
+    bool _loaded;
+
+    QHash<QString, Frame *> _frames;
+    QHash<QString, QSet<Frame *>> _framesByProject;
+    QSet<Frame *> _activeFrames;
+    FrameIntervalIndex _intervals;
+
+    QFutureWatcher<LoadedFrames> *_reload;
+    // true if the frames were modified while the reload was running
+    bool _reloadOutdated;
+    // set when the store is destroyed, the running reload stops with the next chunk of tom's output
+    QAtomicInt _reloadCancelled;
+};
+
+#endif //TOM_UI_FRAMESTORE_H
@@ -48,3 +48,31 @@ const QHash<QString, ProjectStatus> &ProjectsStatus::getMapping() const {
 ProjectStatus ProjectsStatus::getOverallStatus() {
     return get("ALL");
 }
+
+// the timespans in the order of the stream
+static Timespan ProjectStatus::* const STREAMED_SPANS[] = {
+        &ProjectStatus::all, &ProjectStatus::allTotal,
+        &ProjectStatus::year, &ProjectStatus::yearTotal,
+        &ProjectStatus::month, &ProjectStatus::monthTotal,
+        &ProjectStatus::week, &ProjectStatus::weekTotal,
+        &ProjectStatus::yesterday, &ProjectStatus::yesterdayTotal,
+        &ProjectStatus::day, &ProjectStatus::dayTotal
+};
+
+QDataStream &operator<<(QDataStream &out, const ProjectStatus &status) {
+    out << status.id;
+    for (auto span : STREAMED_SPANS) {
+        out << qint64((status.*span).asMillis());
+    }
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, ProjectStatus &status) {
+    in >> status.id;
+    for (auto span : STREAMED_SPANS) {
+        qint64 millis = 0;
+        in >> millis;
+        status.*span = Timespan(millis);
+    }
+    return in;
+}
@@ -1,6 +1,7 @@
 #ifndef TOM_UI_PROJECTSTATUS_H
 #define TOM_UI_PROJECTSTATUS_H
 
+#include <QtCore/QDataStream>
 #include <QtCore/QHash>
 #include <QtCore/QObject>
 
@@ -60,6 +61,8 @@ private:
 
 inline bool operator==(const ProjectStatus &a, const ProjectStatus &b) {
     return a.id == b.id &&
+           a.day == b.day &&
+           a.dayTotal == b.dayTotal &&
            a.yesterday == b.yesterday &&
            a.yesterdayTotal == b.yesterdayTotal &&
            a.week == b.week &&
@@ -67,10 +70,16 @@ inline bool operator==(const ProjectStatus &a, const ProjectStatus &b) {
            a.month == b.month &&
            a.monthTotal == b.monthTotal &&
            a.year == b.year &&
-           a.yearTotal == b.yearTotal;
+           a.yearTotal == b.yearTotal &&
+           a.all == b.all &&
+           a.allTotal == b.allTotal;
 }
 
 inline bool operator!=(const ProjectStatus &a, const ProjectStatus &b) { return !operator==(a, b); }
 
+QDataStream &operator<<(QDataStream &out, const ProjectStatus &status);
+
+QDataStream &operator>>(QDataStream &in, ProjectStatus &status);
+
 
 #endif //TOM_UI_PROJECTSTATUS_H
@@ -1,52 +1,186 @@
+#include <QtConcurrent/QtConcurrent>
+
 #include "ProjectStatusManager.h"
 
-ProjectStatusManager::ProjectStatusManager(TomControl *control, QObject *parent) : QObject(parent), _control(control) {
-    refresh();
+ProjectStatusManager::ProjectStatusManager(TomControl *control, QObject *parent) : QObject(parent),
+                                                                                   _control(control),
+                                                                                   _overallSlot(statusSlot(ProjectStatus::OVERALL_ID)),
+                                                                                   _statusLoad(new QFutureWatcher<ProjectsStatus>(this)) {
+    connect(_statusLoad, &QFutureWatcher<ProjectsStatus>::finished, this, &ProjectStatusManager::onStatusLoaded);
 
-    connect(_control, &TomControl::dataResetNeeded, this, &ProjectStatusManager::refresh);
+    // the status is computed from the frames, tom's status command is only used to verify it
+    // the frames are loaded once for the status and the rollup
+    _frameStore = new FrameStore(control, this);
+    _aggregator = new ProjectTimeAggregator(control, _frameStore, _includeArchived, this);
+    connect(_aggregator, &ProjectTimeAggregator::changed, this, &ProjectStatusManager::refresh);
+    _rollupCube = new RollupCube(control, _frameStore, this);
 
+    // refresh the durations of the active frames every minute, this also handles the change of the day
+    control->scheduler()->addTask("project status", 60 * 1000, RefreshScheduler::ViewTask, this, [this] { refresh(); });
+    control->scheduler()->addTask("verify project status", 10 * 60 * 1000, RefreshScheduler::BackgroundTask, this, [this] { verify(); });
+}
 
-    connect(_control, &TomControl::projectStatusChanged, this, &ProjectStatusManager::refresh);
-    connect(_control, &TomControl::projectUpdated, this, &ProjectStatusManager::refresh);
-    connect(_control, &TomControl::projectFramesArchived, this, &ProjectStatusManager::refresh);
+ProjectStatusManager::~ProjectStatusManager() {
+    // tom's status command is short, it's limited by the timeout of the command
+    _statusLoad->waitForFinished();
+}
 
-    connect(_control, &TomControl::framesUpdated, this, &ProjectStatusManager::refresh);
-    connect(_control, &TomControl::framesRemoved, this, &ProjectStatusManager::refresh);
-    connect(_control, &TomControl::framesMoved, this, &ProjectStatusManager::refresh);
-    connect(_control, &TomControl::framesArchived, [this] {
-        if (!_includeArchived) {
-            refresh();
-        }
-    });
+const ProjectStatus &ProjectStatusManager::getStatus(const QString &projectID) const {
+    // projects without status are displayed with an empty status
+    static const ProjectStatus empty;
 
-    // refresh project tree status every minute
-    _timer = new QTimer(this);
-    connect(_timer, &QTimer::timeout, this, &ProjectStatusManager::refresh);
-    _timer->start(60 * 1000);
+    auto slot = _slots.constFind(projectID);
+    return slot == _slots.constEnd() ? empty : _statuses.at(slot.value());
 }
 
-ProjectStatus ProjectStatusManager::getStatus(const QString &projectID) const {
-    return _statusCache.get(projectID);
+int ProjectStatusManager::statusSlot(const QString &projectID) {
+    auto slot = _slots.constFind(projectID);
+    if (slot != _slots.constEnd()) {
+        return slot.value();
+    }
+
+    _statuses.emplace_back();
+    _versions.push_back(1);
+
+    const int index = static_cast<int>(_statuses.size()) - 1;
+    _slots.insert(projectID, index);
+    return index;
 }
 
 // load new status, compare to old and emit signal for modified entries
 void ProjectStatusManager::refresh() {
-    //fixme we could diff old vs new state and only update the modified project status info. atm it's quick enough
-    _statusCache = loadStatus();
-    emit projectsStatusChanged(_statusCache.getMapping().keys());
+    if (_aggregator->isLoaded()) {
+        updateStatus(_aggregator->status());
+    } else {
+        loadStatus();
+    }
+}
+
+void ProjectStatusManager::verify() {
+    if (_aggregator->isLoaded()) {
+        loadStatus();
+    }
+}
+
+void ProjectStatusManager::loadStatus() {
+    if (_statusLoad->isRunning()) {
+        return;
+    }
+
+    const TomControl *control = _control;
+    _statusLoadArchived = _includeArchived;
+    const bool includeArchived = _includeArchived;
+    _statusLoad->setFuture(QtConcurrent::run([control, includeArchived] {
+        return control->projectsStatus(ProjectStatus::OVERALL_ID, true, includeArchived);
+    }));
 }
 
-ProjectsStatus ProjectStatusManager::loadStatus() {
-    return _control->projectsStatus(ProjectStatus::OVERALL_ID, true, _includeArchived);
+void ProjectStatusManager::onStatusLoaded() {
+    const ProjectsStatus &remote = _statusLoad->result();
+    if (_statusLoadArchived != _includeArchived) {
+        // the status doesn't match the displayed frames
+        return;
+    }
+
+    if (!_aggregator->isLoaded()) {
+        updateStatus(remote);
+        return;
+    }
+
+    const ProjectsStatus &local = _aggregator->status();
+    for (auto it = remote.getMapping().constBegin(); it != remote.getMapping().constEnd(); ++it) {
+        if (!isSimilar(it.value(), local.get(it.key()))) {
+            // tom's data was modified outside of the application
+            qWarning() << "local status of project" << it.key() << "differs from tom's status, reloading";
+            _control->markDataChanged();
+            _frameStore->reload();
+            updateStatus(remote);
+            return;
+        }
+    }
 }
 
-ProjectStatus ProjectStatusManager::getOverallStatus() const {
-    return _statusCache.get(ProjectStatus::OVERALL_ID);
+void ProjectStatusManager::updateStatus(const ProjectsStatus &status) {
+    const QHash<QString, ProjectStatus> &mapping = status.getMapping();
+
+    QStringList changed;
+    for (auto it = mapping.constBegin(); it != mapping.constEnd(); ++it) {
+        const int slot = statusSlot(it.key());
+        ProjectStatus &stored = _statuses[slot];
+        if (stored != it.value()) {
+            stored = it.value();
+            _versions[slot]++;
+            changed << it.key();
+        }
+    }
+
+    // projects which are not part of the new status are displayed with empty values
+    for (auto it = _slots.constBegin(); it != _slots.constEnd(); ++it) {
+        ProjectStatus &stored = _statuses[it.value()];
+        if (!stored.id.isEmpty() && !mapping.contains(it.key())) {
+            stored = ProjectStatus();
+            _versions[it.value()]++;
+            changed << it.key();
+        }
+    }
+
+    if (!changed.isEmpty()) {
+        emit projectsStatusChanged(changed);
+    }
+}
+
+bool ProjectStatusManager::isSimilar(const ProjectStatus &a, const ProjectStatus &b) {
+    // active frames are growing while the commands are running
+    const qint64 tolerance = 60 * 1000;
+    auto similar = [tolerance](const Timespan &x, const Timespan &y) {
+        return qAbs(x.asMillis() - y.asMillis()) <= tolerance;
+    };
+
+    return similar(a.day, b.day) && similar(a.dayTotal, b.dayTotal)
+           && similar(a.yesterday, b.yesterday) && similar(a.yesterdayTotal, b.yesterdayTotal)
+           && similar(a.week, b.week) && similar(a.weekTotal, b.weekTotal)
+           && similar(a.month, b.month) && similar(a.monthTotal, b.monthTotal)
+           && similar(a.year, b.year) && similar(a.yearTotal, b.yearTotal)
+           && similar(a.all, b.all) && similar(a.allTotal, b.allTotal);
+}
+
+const ProjectStatus &ProjectStatusManager::getOverallStatus() const {
+    return _statuses.at(_overallSlot);
+}
+
+FrameStore *ProjectStatusManager::frameStore() const {
+    return _frameStore;
+}
+
+RollupCube *ProjectStatusManager::rollupCube() const {
+    return _rollupCube;
+}
+
+void ProjectStatusManager::loadFrames(const QList<Frame *> &frames) {
+    _frameStore->setFrames(frames);
+}
+
+void ProjectStatusManager::setSnapshotStatus(const ProjectsStatus &status) {
+    if (!_aggregator->isLoaded()) {
+        updateStatus(status);
+    }
+}
+
+ProjectsStatus ProjectStatusManager::currentStatus() const {
+    QHash<QString, ProjectStatus> mapping;
+    for (auto it = _slots.constBegin(); it != _slots.constEnd(); ++it) {
+        const ProjectStatus &status = _statuses.at(it.value());
+        if (!status.id.isEmpty()) {
+            mapping.insert(it.key(), status);
+        }
+    }
+    return ProjectsStatus(mapping);
 }
 
 void ProjectStatusManager::setIncludeArchived(bool includeArchived) {
     if (includeArchived != _includeArchived) {
         _includeArchived = includeArchived;
-        refresh();
+        // reloading emits changed(), which refreshes the status
+        _aggregator->setIncludeArchived(includeArchived);
     }
 }
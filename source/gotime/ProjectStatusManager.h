@@ -1,17 +1,72 @@
 #ifndef TOM_UI_PROJECTSTATUSMANAGER_H
 #define TOM_UI_PROJECTSTATUSMANAGER_H
 
+#include <deque>
+
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QObject>
 #include "TomControl.h"
+#include "FrameStore.h"
+#include "ProjectTimeAggregator.h"
+#include "RollupCube.h"
 
 class ProjectStatusManager : public QObject {
 Q_OBJECT
 public:
     ProjectStatusManager(TomControl *control, QObject *parent);
 
-    ProjectStatus getStatus(const QString &projectID) const;
+    ~ProjectStatusManager() override;
+
+    const ProjectStatus &getStatus(const QString &projectID) const;
+
+    const ProjectStatus &getOverallStatus() const;
+
+    /**
+     * @return The frames of all projects, which are loaded once for the status and the reports.
+     */
+    FrameStore *frameStore() const;
+
+    /**
+     * @return The daily totals of all frames, which are used for reports.
+     */
+    RollupCube *rollupCube() const;
+
+    /**
+     * Computes the status from the given frames, which must include the archived frames.
+     * The status is empty until the frames were loaded.
+     */
+    void loadFrames(const QList<Frame *> &frames);
+
+    /**
+     * Displays the status of the startup snapshot until the frames were loaded.
+     */
+    void setSnapshotStatus(const ProjectsStatus &status);
+
+    /**
+     * @return The status of all projects, which is currently displayed.
+     */
+    ProjectsStatus currentStatus() const;
+
+    /**
+     * @return The slot of the project's status, which is created on first access.
+     * A slot never changes, it's valid until the application quits.
+     */
+    int statusSlot(const QString &projectID);
 
-    ProjectStatus getOverallStatus() const;
+    /**
+     * @return The status stored in the slot, without any hashing or copying.
+     * The reference stays valid when slots are added later.
+     */
+    inline const ProjectStatus &statusAt(int slot) const {
+        return _statuses.at(slot);
+    }
+
+    /**
+     * @return A number which is incremented whenever the status in the slot changes.
+     */
+    inline quint32 statusVersion(int slot) const {
+        return _versions.at(slot);
+    }
 
 public slots:
 
@@ -25,17 +80,43 @@ private slots:
 
     void refresh();
 
+    /**
+     * Compares the locally computed status with the status reported by tom.
+     */
+    void verify();
+
+    /**
+     * Displays tom's status until the frames were loaded, afterwards it's compared with the computed status.
+     */
+    void onStatusLoaded();
+
 private:
     /**
-     * Loads a new status map from the tom cli application.
+     * Loads a new status map from the tom cli application in the background.
      */
-    ProjectsStatus loadStatus();
+    void loadStatus();
+
+    static bool isSimilar(const ProjectStatus &a, const ProjectStatus &b);
+
+    void updateStatus(const ProjectsStatus &status);
 
-    QTimer *_timer;
     TomControl *_control;
+    FrameStore *_frameStore;
+    ProjectTimeAggregator *_aggregator;
+    RollupCube *_rollupCube;
+
+    // the status of all projects, the slots are assigned on first access
+    // a deque never moves its elements when slots are appended, returned references stay valid
+    std::deque<ProjectStatus> _statuses;
+    std::deque<quint32> _versions;
+    QHash<QString, int> _slots;
+    int _overallSlot;
 
-    ProjectsStatus _statusCache;
     bool _includeArchived = true;
+
+    QFutureWatcher<ProjectsStatus> *_statusLoad;
+    // the archived frames are part of the loaded status
+    bool _statusLoadArchived = true;
 };
 
 
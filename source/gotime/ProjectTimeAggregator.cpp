@@ -0,0 +1,232 @@
+#include "ProjectTimeAggregator.h"
+
+ProjectTimeAggregator::ProjectTimeAggregator(TomControl *control, FrameStore *frames, bool includeArchived, QObject *parent) : QObject(parent),
+                                                                                                                            _control(control),
+                                                                                                                            _frames(frames),
+                                                                                                                            _includeArchived(includeArchived) {
+    connect(_frames, &FrameStore::framesReset, this, &ProjectTimeAggregator::onFramesReset);
+    connect(_frames, &FrameStore::frameRemoved, this, &ProjectTimeAggregator::onFrameRemoved);
+    connect(_frames, &FrameStore::frameAdded, this, &ProjectTimeAggregator::onFrameAdded);
+    connect(_frames, &FrameStore::changed, this, &ProjectTimeAggregator::changed);
+
+    // the hierarchy is only used to compute the totals
+    connect(_control, &TomControl::projectCreated, this, &ProjectTimeAggregator::onHierarchyChanged);
+    connect(_control, &TomControl::projectUpdated, this, &ProjectTimeAggregator::onHierarchyChanged);
+    connect(_control, &TomControl::projectHierarchyChanged, this, &ProjectTimeAggregator::onHierarchyChanged);
+
+    resetBuckets();
+    rebuildTotals();
+}
+
+bool ProjectTimeAggregator::isLoaded() const {
+    return _frames->isLoaded();
+}
+
+void ProjectTimeAggregator::setIncludeArchived(bool includeArchived) {
+    if (includeArchived != _includeArchived) {
+        _includeArchived = includeArchived;
+
+        // the store keeps the archived frames, only the buckets change
+        resetBuckets();
+        rebuildTotals();
+        emit changed();
+    }
+}
+
+ProjectsStatus ProjectTimeAggregator::status() {
+    const QDate &today = QDate::currentDate();
+    if (today != _starts.today) {
+        resetPeriods(today);
+        rebuildTotals();
+    }
+
+    // active frames are not part of the buckets, they're growing until they're stopped
+    QHash<QString, Periods> activeOwn;
+    QHash<QString, Periods> activeTotals;
+    Periods overall = _overall;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const auto *frame : _frames->activeFrames()) {
+        if (!isCounted(frame)) {
+            continue;
+        }
+
+        const qint64 start = frame->startTime.toMSecsSinceEpoch();
+        Periods periods;
+        periods.all = qMax(qint64(0), now - start);
+        forEachDay(start, now, [this, &periods](const QDate &day, qint64 millis) {
+            addToPeriods(periods, day, millis, _starts);
+        });
+
+        activeOwn[frame->projectID] += periods;
+        addToTotals(activeTotals, overall, frame->projectID, periods);
+    }
+
+    QHash<QString, ProjectStatus> mapping;
+    auto addStatus = [&mapping](QString id, const Periods &o, const Periods &t) {
+        mapping.insert(id, ProjectStatus(id, Timespan(o.all), Timespan(t.all),
+                                         Timespan(o.year), Timespan(t.year),
+                                         Timespan(o.month), Timespan(t.month),
+                                         Timespan(o.week), Timespan(t.week),
+                                         Timespan(o.yesterday), Timespan(t.yesterday),
+                                         Timespan(o.day), Timespan(t.day)));
+    };
+
+    for (const auto &project : _control->cachedProjects()) {
+        const QString &id = project.getID();
+        Periods own = _own.value(id);
+        own += activeOwn.value(id);
+        Periods totals = _totals.value(id);
+        totals += activeTotals.value(id);
+        addStatus(id, own, totals);
+    }
+    addStatus(ProjectStatus::OVERALL_ID, overall, overall);
+
+    return ProjectsStatus(mapping);
+}
+
+void ProjectTimeAggregator::onFramesReset() {
+    resetBuckets();
+    rebuildTotals();
+}
+
+void ProjectTimeAggregator::onFrameRemoved(const Frame *frame) {
+    if (frame->stopTime.isValid() && isCounted(frame)) {
+        addToTotals(_totals, _overall, frame->projectID, addToBuckets(frame, -1));
+    }
+}
+
+void ProjectTimeAggregator::onFrameAdded(const Frame *frame) {
+    if (frame->stopTime.isValid() && isCounted(frame)) {
+        addToTotals(_totals, _overall, frame->projectID, addToBuckets(frame, 1));
+    }
+}
+
+void ProjectTimeAggregator::onHierarchyChanged() {
+    rebuildTotals();
+    emit changed();
+}
+
+bool ProjectTimeAggregator::isCounted(const Frame *frame) const {
+    return _includeArchived || !frame->archived;
+}
+
+ProjectTimeAggregator::Periods ProjectTimeAggregator::addToBuckets(const Frame *frame, int sign) {
+    const qint64 start = frame->startTime.toMSecsSinceEpoch();
+    const qint64 stop = frame->stopTime.toMSecsSinceEpoch();
+
+    Periods delta;
+    delta.all = sign * qMax(qint64(0), stop - start);
+
+    QMap<QDate, qint64> &days = _buckets[frame->projectID];
+    forEachDay(start, stop, [this, &days, &delta, sign](const QDate &day, qint64 millis) {
+        qint64 &value = days[day];
+        value += sign * millis;
+        if (value == 0) {
+            days.remove(day);
+        }
+        addToPeriods(delta, day, sign * millis, _starts);
+    });
+
+    _own[frame->projectID] += delta;
+    return delta;
+}
+
+void ProjectTimeAggregator::resetBuckets() {
+    _buckets.clear();
+    _own.clear();
+    _starts = PeriodStarts(QDate::currentDate());
+
+    for (const auto *frame : _frames->frames()) {
+        if (frame->stopTime.isValid() && isCounted(frame)) {
+            addToBuckets(frame, 1);
+        }
+    }
+}
+
+void ProjectTimeAggregator::resetPeriods(const QDate &today) {
+    _starts = PeriodStarts(today);
+    // the week may have started in the previous year
+    const QDate &first = qMin(_starts.week, _starts.year);
+
+    for (auto it = _buckets.constBegin(); it != _buckets.constEnd(); ++it) {
+        Periods periods;
+        periods.all = _own.value(it.key()).all;
+
+        const QMap<QDate, qint64> &days = it.value();
+        for (auto day = days.lowerBound(first); day != days.constEnd() && day.key() <= _starts.today; ++day) {
+            addToPeriods(periods, day.key(), day.value(), _starts);
+        }
+        _own.insert(it.key(), periods);
+    }
+}
+
+void ProjectTimeAggregator::rebuildTotals() {
+    _totals.clear();
+    _overall = Periods();
+    for (auto it = _own.constBegin(); it != _own.constEnd(); ++it) {
+        addToTotals(_totals, _overall, it.key(), it.value());
+    }
+}
+
+void ProjectTimeAggregator::addToTotals(QHash<QString, Periods> &totals, Periods &overall, const QString &projectID, const Periods &delta) const {
+    overall += delta;
+
+    QString id = projectID;
+    for (int depth = 0; !id.isEmpty() && depth < 256; depth++) {
+        totals[id] += delta;
+        id = _control->cachedProject(id).getParentID();
+    }
+}
+
+template<typename Callback>
+void ProjectTimeAggregator::forEachDay(qint64 start, qint64 stop, Callback callback) {
+    // frames spanning midnight contribute to each of the days
+    QDate day = QDateTime::fromMSecsSinceEpoch(start).date();
+    qint64 cursor = start;
+    while (cursor < stop) {
+        const qint64 end = qMin(stop, QDateTime(day.addDays(1), QTime(0, 0)).toMSecsSinceEpoch());
+        callback(day, end - cursor);
+
+        cursor = end;
+        day = day.addDays(1);
+    }
+}
+
+void ProjectTimeAggregator::addToPeriods(Periods &periods, const QDate &day, qint64 millis, const PeriodStarts &starts) {
+    if (day > starts.today) {
+        return;
+    }
+
+    if (day == starts.today) {
+        periods.day += millis;
+    } else if (day == starts.yesterday) {
+        periods.yesterday += millis;
+    }
+
+    if (day >= starts.week) {
+        periods.week += millis;
+    }
+    if (day >= starts.month) {
+        periods.month += millis;
+    }
+    if (day >= starts.year) {
+        periods.year += millis;
+    }
+}
+
+ProjectTimeAggregator::Periods &ProjectTimeAggregator::Periods::operator+=(const Periods &other) {
+    day += other.day;
+    yesterday += other.yesterday;
+    week += other.week;
+    month += other.month;
+    year += other.year;
+    all += other.all;
+    return *this;
+}
+
+ProjectTimeAggregator::PeriodStarts::PeriodStarts(const QDate &today) : today(today),
+                                                                      yesterday(today.addDays(-1)),
+                                                                      week(today.addDays(1 - today.dayOfWeek())),
+                                                                      month(today.year(), today.month(), 1),
+                                                                      year(today.year(), 1, 1) {
+}
@@ -0,0 +1,115 @@
+#ifndef TOM_UI_PROJECTTIMEAGGREGATOR_H
+#define TOM_UI_PROJECTTIMEAGGREGATOR_H
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QSet>
+
+#include "TomControl.h"
+#include "FrameStore.h"
+#include "ProjectStatus.h"
+
+/**
+ * Computes the tracked time of the projects from the frames of the store, without calling tom's status command.
+ * The stopped frames are kept in per-project daily buckets and period totals, which are updated incrementally when
+ * the store's frames are modified. Active frames are added with their live duration.
+ * The totals of the parent projects are rolled up through the hierarchy of the cached projects when it changes.
+ * The periods are recomputed from the buckets when the current day changed.
+ */
+class ProjectTimeAggregator : public QObject {
+Q_OBJECT
+
+public:
+    ProjectTimeAggregator(TomControl *control, FrameStore *frames, bool includeArchived, QObject *parent);
+
+    bool isLoaded() const;
+
+    /**
+     * @return The status of all projects and the overall status, in the same form as TomControl::projectsStatus().
+     */
+    ProjectsStatus status();
+
+public slots:
+
+    void setIncludeArchived(bool includeArchived);
+
+signals:
+
+    /**
+     * Emitted when the tracked times changed after frame updates.
+     */
+    void changed();
+
+private slots:
+
+    void onFramesReset();
+
+    void onFrameRemoved(const Frame *frame);
+
+    void onFrameAdded(const Frame *frame);
+
+    void onHierarchyChanged();
+
+private:
+    struct Periods {
+        qint64 day = 0;
+        qint64 yesterday = 0;
+        qint64 week = 0;
+        qint64 month = 0;
+        qint64 year = 0;
+        qint64 all = 0;
+
+        Periods &operator+=(const Periods &other);
+    };
+
+    // the first days of the periods, relative to the current day
+    struct PeriodStarts {
+        explicit PeriodStarts(const QDate &today = QDate::currentDate());
+
+        QDate today;
+        QDate yesterday;
+        QDate week;
+        QDate month;
+        QDate year;
+    };
+
+    bool isCounted(const Frame *frame) const;
+
+    /**
+     * Adds a stopped frame to the buckets of its project.
+     * @return The change of the periods of the frame's project.
+     */
+    Periods addToBuckets(const Frame *frame, int sign);
+
+    void resetBuckets();
+
+    void resetPeriods(const QDate &today);
+
+    void rebuildTotals();
+
+    /**
+     * Adds the delta to the totals of the project, of all its parents and to the overall totals.
+     */
+    void addToTotals(QHash<QString, Periods> &totals, Periods &overall, const QString &projectID, const Periods &delta) const;
+
+    template<typename Callback>
+    static void forEachDay(qint64 start, qint64 stop, Callback callback);
+
+    static void addToPeriods(Periods &periods, const QDate &day, qint64 millis, const PeriodStarts &starts);
+
+    TomControl *_control;
+    FrameStore *_frames;
+    bool _includeArchived;
+
+    // project id -> day -> tracked millis of the counted, stopped frames of the project
+    QHash<QString, QMap<QDate, qint64>> _buckets;
+    // project id -> periods of the counted, stopped frames of the project
+    QHash<QString, Periods> _own;
+    PeriodStarts _starts;
+    // project id -> periods of the project and its subprojects, without the active frames
+    QHash<QString, Periods> _totals;
+    Periods _overall;
+};
+
+#endif //TOM_UI_PROJECTTIMEAGGREGATOR_H
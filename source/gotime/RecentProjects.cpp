@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QPair>
+#include <QtCore/QSettings>
+#include <QtCore/QVector>
+
+#include "RecentProjects.h"
+
+static const qint64 HALF_LIFE_MILLIS = 7 * 24 * 60 * 60 * 1000LL;
+static const double START_WEIGHT = 1.0;
+static const double STOP_WEIGHT = 0.25;
+// only the most relevant projects are saved
+static const int SAVED_ENTRIES = 200;
+
+RecentProjects::RecentProjects(QObject *parent) : QObject(parent), _maxCount(5) {
+    load();
+}
+
+int RecentProjects::maxCount() const {
+    return _maxCount;
+}
+
+void RecentProjects::setMaxCount(int count) {
+    if (count != _maxCount) {
+        _maxCount = count;
+        emit changed();
+    }
+}
+
+QStringList RecentProjects::projectIDs() const {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QVector<QPair<double, QString>> scores;
+    scores.reserve(_entries.size());
+    for (auto it = _entries.constBegin(); it != _entries.constEnd(); ++it) {
+        scores.append(qMakePair(decayed(it.value(), now), it.key()));
+    }
+    std::sort(scores.begin(), scores.end(), [](const QPair<double, QString> &a, const QPair<double, QString> &b) {
+        return a.first > b.first;
+    });
+
+    QStringList result;
+    result.reserve(scores.size());
+    for (const auto &score : scores) {
+        result << score.second;
+    }
+    return result;
+}
+
+void RecentProjects::setFrames(const QList<Frame *> &frames) {
+    // an empty list is a failed load more likely than a new installation, the saved scores are kept
+    if (frames.isEmpty()) {
+        return;
+    }
+
+    _entries.clear();
+    for (auto *frame : frames) {
+        if (frame->startTime.isValid()) {
+            add(frame->projectID, START_WEIGHT, frame->startTime.toMSecsSinceEpoch());
+        }
+        if (frame->stopTime.isValid()) {
+            add(frame->projectID, STOP_WEIGHT, frame->stopTime.toMSecsSinceEpoch());
+        }
+    }
+    save();
+    emit changed();
+}
+
+void RecentProjects::onProjectStatusChanged(const Project &started, const Project &stopped) {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (stopped.isValid()) {
+        add(stopped.getID(), STOP_WEIGHT, now);
+    }
+    if (started.isValid()) {
+        add(started.getID(), START_WEIGHT, now);
+    }
+
+    if (started.isValid() || stopped.isValid()) {
+        save();
+        emit changed();
+    }
+}
+
+double RecentProjects::decayed(const Entry &entry, qint64 now) {
+    return entry.score * std::pow(0.5, double(now - entry.updated) / HALF_LIFE_MILLIS);
+}
+
+void RecentProjects::add(const QString &projectID, double weight, qint64 time) {
+    auto existing = _entries.find(projectID);
+    if (existing == _entries.end()) {
+        _entries.insert(projectID, Entry{weight, time});
+        return;
+    }
+
+    // the score is stored relative to the later of both times, the frames are not ordered
+    Entry &entry = existing.value();
+    if (time >= entry.updated) {
+        entry.score = decayed(entry, time) + weight;
+        entry.updated = time;
+    } else {
+        entry.score += weight * std::pow(0.5, double(entry.updated - time) / HALF_LIFE_MILLIS);
+    }
+}
+
+void RecentProjects::load() {
+    QSettings settings;
+    const QVariantMap &saved = settings.value("recentProjects/frecency").toMap();
+    for (auto it = saved.constBegin(); it != saved.constEnd(); ++it) {
+        const QVariantList &values = it.value().toList();
+        if (values.size() == 2) {
+            _entries.insert(it.key(), Entry{values.at(0).toDouble(), values.at(1).toLongLong()});
+        }
+    }
+}
+
+void RecentProjects::save() const {
+    QVariantMap saved;
+    for (const auto &id : projectIDs().mid(0, SAVED_ENTRIES)) {
+        const Entry &entry = _entries.value(id);
+        saved.insert(id, QVariantList() << entry.score << entry.updated);
+    }
+
+    QSettings settings;
+    settings.setValue("recentProjects/frecency", saved);
+}
@@ -0,0 +1,67 @@
+#ifndef TOM_UI_RECENTPROJECTS_H
+#define TOM_UI_RECENTPROJECTS_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+#include "data/Frame.h"
+#include "data/Project.h"
+
+/**
+ * Frecency of the projects, i.e. how often and how recently they were used. Each start of a project and each stop
+ * adds to its score, the scores decay with a half-life of a week. The scores are saved in the settings and are
+ * recomputed from the frames when all frames were loaded, which includes the frames tracked by other tom clients.
+ */
+class RecentProjects : public QObject {
+Q_OBJECT
+
+public:
+    explicit RecentProjects(QObject *parent);
+
+    /**
+     * @return The number of recent projects which are displayed by the menus.
+     */
+    int maxCount() const;
+
+    /**
+     * @return The IDs of all used projects, the most relevant first.
+     */
+    QStringList projectIDs() const;
+
+    /**
+     * Replaces the scores with the scores computed from the frames, which must be all frames of tom.
+     * The scores are kept if the list is empty, callers must not pass the frames of a failed or partial load.
+     */
+    void setFrames(const QList<Frame *> &frames);
+
+public slots:
+
+    void setMaxCount(int count);
+
+    void onProjectStatusChanged(const Project &started, const Project &stopped);
+
+signals:
+
+    void changed();
+
+private:
+    struct Entry {
+        // the score at the time of the update
+        double score;
+        qint64 updated;
+    };
+
+    static double decayed(const Entry &entry, qint64 now);
+
+    void add(const QString &projectID, double weight, qint64 time);
+
+    void load();
+
+    void save() const;
+
+    QHash<QString, Entry> _entries;
+    int _maxCount;
+};
+
+#endif //TOM_UI_RECENTPROJECTS_H
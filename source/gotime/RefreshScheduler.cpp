@@ -0,0 +1,182 @@
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+
+#include "RefreshScheduler.h"
+
+// the user is idle after 5 minutes without input
+static const qint64 IDLE_AFTER = 5 * 60 * 1000;
+static const int IDLE_BACKOFF = 4;
+
+RefreshScheduler::RefreshScheduler(QObject *parent) : QObject(parent),
+                                                      _timer(new QTimer(this)),
+                                                      _nextTaskID(1),
+                                                      _viewsVisible(false),
+                                                      _idle(false) {
+    _timer->setSingleShot(true);
+    _timer->setTimerType(Qt::CoarseTimer);
+    connect(_timer, &QTimer::timeout, this, &RefreshScheduler::onTimeout);
+
+    _lastActivity.start();
+    if (QCoreApplication::instance()) {
+        QCoreApplication::instance()->installEventFilter(this);
+    }
+}
+
+int RefreshScheduler::addTask(const QString &name, int intervalMillis, TaskKind kind, QObject *receiver, std::function<void()> callback,
+                              bool enabled) {
+    const int id = _nextTaskID++;
+
+    Task task{name, qMax(qint64(100), qint64(intervalMillis)), kind, enabled, 0, receiver, std::move(callback)};
+    task.nextDue = alignedDue(task, now());
+    _tasks.insert(id, task);
+
+    if (receiver) {
+        connect(receiver, &QObject::destroyed, this, [this, id] { removeTask(id); });
+    }
+
+    reschedule();
+    return id;
+}
+
+void RefreshScheduler::removeTask(int taskID) {
+    if (_tasks.remove(taskID) > 0) {
+        reschedule();
+    }
+}
+
+void RefreshScheduler::setTaskEnabled(int taskID, bool enabled) {
+    auto task = _tasks.find(taskID);
+    if (task == _tasks.end() || task->enabled == enabled) {
+        return;
+    }
+
+    task->enabled = enabled;
+    if (enabled) {
+        task->nextDue = alignedDue(task.value(), now());
+    }
+    reschedule();
+}
+
+bool RefreshScheduler::isUserIdle() const {
+    return _lastActivity.elapsed() > IDLE_AFTER;
+}
+
+int RefreshScheduler::wakeupsPerMinute() const {
+    const qint64 since = now() - 60 * 1000;
+    int count = 0;
+    for (qint64 wakeup : _wakeups) {
+        if (wakeup >= since) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool RefreshScheduler::eventFilter(QObject *watched, QEvent *event) {
+    switch (event->type()) {
+        case QEvent::KeyPress:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseMove:
+        case QEvent::Wheel:
+            _lastActivity.restart();
+            if (_idle) {
+                onUserActivity();
+            }
+            break;
+        default:
+            break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void RefreshScheduler::setViewsVisible(bool visible) {
+    if (visible == _viewsVisible) {
+        return;
+    }
+
+    _viewsVisible = visible;
+
+    if (visible) {
+        // refresh the outdated views right away
+        const qint64 current = now();
+        for (auto &task : _tasks) {
+            if (task.kind == ViewTask && task.enabled && task.nextDue < current) {
+                task.nextDue = current;
+            }
+        }
+    }
+    reschedule();
+}
+
+void RefreshScheduler::onTimeout() {
+    const qint64 current = now();
+    _idle = isUserIdle();
+
+    _wakeups.enqueue(current);
+    while (!_wakeups.isEmpty() && _wakeups.head() < current - 60 * 1000) {
+        _wakeups.dequeue();
+    }
+
+    // the callbacks may add, remove or disable tasks
+    for (int id : _tasks.keys()) {
+        auto task = _tasks.find(id);
+        if (task == _tasks.end() || !isRunnable(task.value())) {
+            continue;
+        }
+
+        // tasks which are due soon are run with this wakeup to save another one
+        const qint64 slack = qMin(effectiveInterval(task.value()) / 4, qint64(5000));
+        if (task->nextDue - slack <= current) {
+            task->nextDue = alignedDue(task.value(), current + slack);
+
+            std::function<void()> callback = task->callback;
+            callback();
+        }
+    }
+
+    reschedule();
+}
+
+bool RefreshScheduler::isRunnable(const Task &task) const {
+    return task.enabled && task.receiver && (task.kind == BackgroundTask || _viewsVisible);
+}
+
+qint64 RefreshScheduler::effectiveInterval(const Task &task) const {
+    return _idle ? task.interval * IDLE_BACKOFF : task.interval;
+}
+
+qint64 RefreshScheduler::alignedDue(const Task &task, qint64 now) const {
+    // all tasks with a common interval wake up at the same time
+    const qint64 interval = effectiveInterval(task);
+    return (now / interval + 1) * interval;
+}
+
+void RefreshScheduler::reschedule() {
+    qint64 next = -1;
+    for (const auto &task : _tasks) {
+        if (isRunnable(task) && (next < 0 || task.nextDue < next)) {
+            next = task.nextDue;
+        }
+    }
+
+    if (next < 0) {
+        _timer->stop();
+    } else {
+        _timer->start(static_cast<int>(qBound(qint64(0), next - now(), qint64(24 * 60 * 60 * 1000))));
+    }
+}
+
+void RefreshScheduler::onUserActivity() {
+    _idle = false;
+
+    // the due times of the idle state are too late
+    const qint64 current = now();
+    for (auto &task : _tasks) {
+        task.nextDue = qMin(task.nextDue, alignedDue(task, current));
+    }
+    reschedule();
+}
+
+qint64 RefreshScheduler::now() {
+    return QDateTime::currentMSecsSinceEpoch();
+}
@@ -0,0 +1,97 @@
+#ifndef TOM_UI_REFRESHSCHEDULER_H
+#define TOM_UI_REFRESHSCHEDULER_H
+
+#include <functional>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QQueue>
+#include <QtCore/QTimer>
+
+/**
+ * Runs all periodic work of the application with a single timer.
+ * The due times of the tasks are aligned to multiples of their intervals, tasks which are due at about the same time
+ * are run by the same wakeup. View tasks are suspended while the main window isn't visible and are run when it's
+ * shown again. When there was no user input for a while, the intervals of all tasks are multiplied.
+ */
+class RefreshScheduler : public QObject {
+Q_OBJECT
+
+public:
+    enum TaskKind {
+        // refreshes data which is used even when no window is visible
+        BackgroundTask,
+        // refreshes data which is only displayed by the main window
+        ViewTask
+    };
+
+    explicit RefreshScheduler(QObject *parent);
+
+    /**
+     * Adds a periodic task. The task is removed when the receiver is destroyed.
+     * @return The ID of the new task.
+     */
+    int addTask(const QString &name, int intervalMillis, TaskKind kind, QObject *receiver, std::function<void()> callback,
+                bool enabled = true);
+
+    void removeTask(int taskID);
+
+    /**
+     * Disabled tasks don't wake up the application. An enabled task is run at its next aligned due time.
+     */
+    void setTaskEnabled(int taskID, bool enabled);
+
+    bool isUserIdle() const;
+
+    /**
+     * @return The number of wakeups during the last minute.
+     */
+    int wakeupsPerMinute() const;
+
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+public slots:
+
+    void setViewsVisible(bool visible);
+
+private slots:
+
+    void onTimeout();
+
+private:
+    struct Task {
+        QString name;
+        qint64 interval;
+        TaskKind kind;
+        bool enabled;
+        qint64 nextDue;
+        QPointer<QObject> receiver;
+        std::function<void()> callback;
+    };
+
+    bool isRunnable(const Task &task) const;
+
+    qint64 effectiveInterval(const Task &task) const;
+
+    qint64 alignedDue(const Task &task, qint64 now) const;
+
+    void reschedule();
+
+    void onUserActivity();
+
+    static qint64 now();
+
+    QTimer *_timer;
+    QHash<int, Task> _tasks;
+    int _nextTaskID;
+
+    bool _viewsVisible;
+    QElapsedTimer _lastActivity;
+    bool _idle;
+
+    QQueue<qint64> _wakeups;
+};
+
+#endif //TOM_UI_REFRESHSCHEDULER_H
@@ -0,0 +1,76 @@
+#ifndef TOM_UI_REPORTOPTIONS_H
+#define TOM_UI_REPORTOPTIONS_H
+
+#include <QtCore/QDate>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+enum TimeRoundingMode {
+    NONE, UP, NEAREST, DOWN
+};
+
+/**
+ * @return The duration of a single frame, rounded to a multiple of the given minutes.
+ */
+inline qint64 roundedMillis(qint64 millis, TimeRoundingMode mode, int minutes) {
+    const qint64 step = qint64(minutes) * 60 * 1000;
+    if (step <= 0) {
+        return millis;
+    }
+
+    switch (mode) {
+        case UP:
+            return (millis + step - 1) / step * step;
+        case DOWN:
+            return millis / step * step;
+        case NEAREST:
+            return (millis + step / 2) / step * step;
+        case NONE:
+            break;
+    }
+    return millis;
+}
+
+/**
+ * The parameters of a report of tom.
+ */
+struct ReportOptions {
+    QStringList projectIDs;
+    bool includeSubprojects = false;
+    QDate start;
+    QDate end;
+    TimeRoundingMode frameRoundingMode = NONE;
+    int frameRoundingMinutes = 0;
+    QStringList splits;
+    QString templateID;
+    bool matrixTables = false;
+    bool showEmpty = false;
+    bool showSummary = false;
+    bool includeArchived = false;
+    QString title;
+    QString description;
+    bool showSales = false;
+    bool showTracked = false;
+    bool showUntracked = false;
+    QString cssFile;
+    bool decimalTimeFormat = false;
+    // generate the report with ReportEngine instead of tom
+    bool nativeEngine = false;
+};
+
+inline bool operator==(const ReportOptions &a, const ReportOptions &b) {
+    return a.projectIDs == b.projectIDs && a.includeSubprojects == b.includeSubprojects
+           && a.start == b.start && a.end == b.end
+           && a.frameRoundingMode == b.frameRoundingMode && a.frameRoundingMinutes == b.frameRoundingMinutes
+           && a.splits == b.splits && a.templateID == b.templateID
+           && a.matrixTables == b.matrixTables && a.showEmpty == b.showEmpty && a.showSummary == b.showSummary
+           && a.includeArchived == b.includeArchived
+           && a.title == b.title && a.description == b.description
+           && a.showSales == b.showSales && a.showTracked == b.showTracked && a.showUntracked == b.showUntracked
+           && a.cssFile == b.cssFile && a.decimalTimeFormat == b.decimalTimeFormat
+           && a.nativeEngine == b.nativeEngine;
+}
+
+inline bool operator!=(const ReportOptions &a, const ReportOptions &b) { return !operator==(a, b); }
+
+#endif //TOM_UI_REPORTOPTIONS_H
@@ -0,0 +1,73 @@
+#include <QtCore/QDebug>
+
+#include "ReportProcess.h"
+
+ReportProcess::ReportProcess(const QString &program, const QStringList &args, int timeoutMillis, QObject *parent) : QObject(parent),
+                                                                                                                   _process(new QProcess(this)),
+                                                                                                                   _timeout(new QTimer(this)),
+                                                                                                                   _done(false) {
+    connect(_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &ReportProcess::onFinished);
+    connect(_process, &QProcess::errorOccurred, this, &ReportProcess::onError);
+
+    _timeout->setSingleShot(true);
+    connect(_timeout, &QTimer::timeout, [this] {
+        qWarning() << "report process timed out";
+        cancel();
+        emit finished(false, QString());
+    });
+
+    _process->start(program, args);
+    _timeout->start(timeoutMillis);
+}
+
+ReportProcess::~ReportProcess() {
+    cancel();
+}
+
+bool ReportProcess::isRunning() const {
+    return !_done;
+}
+
+void ReportProcess::cancel() {
+    if (_done) {
+        return;
+    }
+
+    _done = true;
+    _timeout->stop();
+    _process->disconnect(this);
+    if (_process->state() != QProcess::NotRunning) {
+        // the destructor of a running QProcess blocks until it exited,
+        // the killed process deletes itself when it finished instead
+        QProcess *process = _process;
+        _process = nullptr;
+        process->setParent(nullptr);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), process, &QObject::deleteLater);
+        process->kill();
+    }
+}
+
+void ReportProcess::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (_done) {
+        return;
+    }
+    _done = true;
+    _timeout->stop();
+
+    const QString output(_process->readAllStandardOutput());
+    const bool success = exitStatus == QProcess::NormalExit && exitCode == 0;
+    if (!success) {
+        qDebug() << "report failed, exit code:" << exitCode << "stderr" << _process->readAllStandardError();
+    }
+    emit finished(success, output);
+}
+
+void ReportProcess::onError(QProcess::ProcessError error) {
+    // errors of running processes are followed by finished()
+    if (error == QProcess::FailedToStart && !_done) {
+        _done = true;
+        _timeout->stop();
+        qWarning() << "report process failed to start:" << _process->errorString();
+        emit finished(false, QString());
+    }
+}
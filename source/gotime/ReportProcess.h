@@ -0,0 +1,45 @@
+#ifndef TOM_UI_REPORTPROCESS_H
+#define TOM_UI_REPORTPROCESS_H
+
+#include <QtCore/QObject>
+#include <QtCore/QProcess>
+#include <QtCore/QTimer>
+
+/**
+ * A tom report which is generated in the background.
+ * The process is killed when the report is cancelled or deleted.
+ */
+class ReportProcess : public QObject {
+Q_OBJECT
+
+public:
+    ReportProcess(const QString &program, const QStringList &args, int timeoutMillis, QObject *parent);
+
+    ~ReportProcess() override;
+
+    bool isRunning() const;
+
+public slots:
+
+    /**
+     * Kills the process. finished() isn't emitted for a cancelled report.
+     */
+    void cancel();
+
+signals:
+
+    void finished(bool success, const QString &output);
+
+private slots:
+
+    void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
+
+    void onError(QProcess::ProcessError error);
+
+private:
+    QProcess *_process;
+    QTimer *_timeout;
+    bool _done;
+};
+
+#endif //TOM_UI_REPORTPROCESS_H
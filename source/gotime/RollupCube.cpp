@@ -0,0 +1,147 @@
+#include "RollupCube.h"
+
+// the rounding steps in minutes, which are precomputed for each cell
+static const int ROUNDING_STEPS[] = {1, 5, 6, 10, 15, 30, 60};
+static const int ROUNDING_STEP_COUNT = sizeof(ROUNDING_STEPS) / sizeof(ROUNDING_STEPS[0]);
+static const TimeRoundingMode ROUNDING_MODES[] = {UP, NEAREST, DOWN};
+static const int ROUNDED_VALUES = ROUNDING_STEP_COUNT * 3;
+
+RollupCube::RollupCube(TomControl *control, FrameStore *frames, QObject *parent) : QObject(parent),
+                                                                                  _control(control),
+                                                                                  _frames(frames) {
+    connect(_frames, &FrameStore::framesReset, this, &RollupCube::onFramesReset);
+    connect(_frames, &FrameStore::frameRemoved, this, &RollupCube::onFrameRemoved);
+    connect(_frames, &FrameStore::frameAdded, this, &RollupCube::onFrameAdded);
+
+    onFramesReset();
+}
+
+bool RollupCube::supportsRounding(TimeRoundingMode mode, int minutes) {
+    return mode == NONE || minutes <= 0 || roundedIndex(mode, minutes) >= 0;
+}
+
+bool RollupCube::canAnswer(const ReportOptions &options) const {
+    // the cells must not be older than tom's data
+    return _frames->isLoaded() && supportsRounding(options.frameRoundingMode, options.frameRoundingMinutes);
+}
+
+void RollupCube::forEachCell(const ReportOptions &options, const CellCallback &callback) const {
+    QSet<QString> projectIDs;
+    if (options.projectIDs.isEmpty()) {
+        projectIDs = _cells.keys().toSet();
+    } else {
+        for (const auto &id : options.projectIDs) {
+            projectIDs += _control->projectIDs(id, options.includeSubprojects).toSet();
+        }
+    }
+
+    const int index = roundedIndex(options.frameRoundingMode, options.frameRoundingMinutes);
+    for (const auto &projectID : projectIDs) {
+        auto days = _cells.constFind(projectID);
+        if (days == _cells.constEnd()) {
+            continue;
+        }
+
+        auto it = options.start.isValid() ? days->lowerBound(options.start) : days->constBegin();
+        for (; it != days->constEnd() && (!options.end.isValid() || it.key() <= options.end); ++it) {
+            Totals totals = it->current;
+            if (options.includeArchived) {
+                totals.add(it->archived, 1);
+            }
+
+            if (totals.count > 0) {
+                callback(projectID, it.key(), index >= 0 ? totals.rounded.at(index) : totals.millis, totals.millis);
+            }
+        }
+    }
+
+    // active frames are growing until they're stopped
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const auto *frame : _frames->activeFrames()) {
+        const QDate &day = frame->startTime.date();
+        if (!projectIDs.contains(frame->projectID) || (frame->archived && !options.includeArchived)
+            || (options.start.isValid() && day < options.start) || (options.end.isValid() && day > options.end)) {
+            continue;
+        }
+
+        const qint64 millis = qMax(qint64(0), now - frame->startTime.toMSecsSinceEpoch());
+        callback(frame->projectID, day, roundedMillis(millis, options.frameRoundingMode, options.frameRoundingMinutes), millis);
+    }
+}
+
+void RollupCube::onFramesReset() {
+    _cells.clear();
+    for (const auto *frame : _frames->frames()) {
+        addToCells(frame, 1);
+    }
+}
+
+void RollupCube::onFrameRemoved(const Frame *frame) {
+    addToCells(frame, -1);
+}
+
+void RollupCube::onFrameAdded(const Frame *frame) {
+    addToCells(frame, 1);
+}
+
+RollupCube::Totals RollupCube::frameTotals(qint64 millis) {
+    Totals totals;
+    totals.count = 1;
+    totals.millis = millis;
+    totals.rounded.resize(ROUNDED_VALUES);
+    for (int step = 0; step < ROUNDING_STEP_COUNT; step++) {
+        for (int mode = 0; mode < 3; mode++) {
+            totals.rounded[step * 3 + mode] = roundedMillis(millis, ROUNDING_MODES[mode], ROUNDING_STEPS[step]);
+        }
+    }
+    return totals;
+}
+
+int RollupCube::roundedIndex(TimeRoundingMode mode, int minutes) {
+    if (mode == NONE || minutes <= 0) {
+        return -1;
+    }
+
+    for (int step = 0; step < ROUNDING_STEP_COUNT; step++) {
+        if (ROUNDING_STEPS[step] == minutes) {
+            for (int i = 0; i < 3; i++) {
+                if (ROUNDING_MODES[i] == mode) {
+                    return step * 3 + i;
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+void RollupCube::addToCells(const Frame *frame, int sign) {
+    if (!frame->stopTime.isValid()) {
+        return;
+    }
+
+    const QDate &day = frame->startTime.date();
+    QMap<QDate, Cell> &days = _cells[frame->projectID];
+
+    const qint64 millis = qMax(qint64(0), frame->stopTime.toMSecsSinceEpoch() - frame->startTime.toMSecsSinceEpoch());
+    Cell &cell = days[day];
+    (frame->archived ? cell.archived : cell.current).add(frameTotals(millis), sign);
+    if (cell.isEmpty()) {
+        days.remove(day);
+    }
+}
+
+void RollupCube::Totals::add(const Totals &other, int sign) {
+    if (rounded.isEmpty()) {
+        rounded.resize(ROUNDED_VALUES);
+    }
+
+    count += sign * other.count;
+    millis += sign * other.millis;
+    for (int i = 0; i < other.rounded.size() && i < rounded.size(); i++) {
+        rounded[i] += sign * other.rounded.at(i);
+    }
+}
+
+bool RollupCube::Cell::isEmpty() const {
+    return current.count == 0 && archived.count == 0;
+}
@@ -0,0 +1,87 @@
+#ifndef TOM_UI_ROLLUPCUBE_H
+#define TOM_UI_ROLLUPCUBE_H
+
+#include <functional>
+
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+
+#include "TomControl.h"
+#include "FrameStore.h"
+#include "ReportOptions.h"
+
+/**
+ * Materialized totals of the frames per project and day, the day of a frame is the day of its start like in reports.
+ * Each cell stores the number of frames, the exact duration and the durations rounded frame by frame for common
+ * rounding steps. Reports without time entries are computed from the cells, i.e. in O(days × projects) instead of
+ * O(frames), for any selection of projects, date range and split by project, year, month, week or day.
+ * The cells are built from the frames of the store and are updated incrementally when its frames are modified.
+ * They don't answer queries until the store loaded tom's frames. Active frames are not part of the cells, they're
+ * added with their current duration. The earnings aren't stored, they're the rounded durations times the current
+ * hourly rates, which are applied by the report.
+ */
+class RollupCube : public QObject {
+Q_OBJECT
+
+public:
+    typedef std::function<void(const QString &projectID, const QDate &day, qint64 millis, qint64 exactMillis)> CellCallback;
+
+    RollupCube(TomControl *control, FrameStore *frames, QObject *parent);
+
+    /**
+     * @return true if the cells have totals for the rounding of the options.
+     */
+    static bool supportsRounding(TimeRoundingMode mode, int minutes);
+
+    /**
+     * @return true if the totals of a report with these options can be computed from the cells.
+     */
+    bool canAnswer(const ReportOptions &options) const;
+
+    /**
+     * Calls the callback for each cell of the projects and the date range of the options.
+     * The rounding of the options is applied to the durations.
+     */
+    void forEachCell(const ReportOptions &options, const CellCallback &callback) const;
+
+private slots:
+
+    void onFramesReset();
+
+    void onFrameRemoved(const Frame *frame);
+
+    void onFrameAdded(const Frame *frame);
+
+private:
+    struct Totals {
+        qint64 count = 0;
+        qint64 millis = 0;
+        // the rounded durations, see roundedIndex()
+        QVector<qint64> rounded;
+
+        void add(const Totals &other, int sign);
+    };
+
+    struct Cell {
+        Totals current;
+        Totals archived;
+
+        bool isEmpty() const;
+    };
+
+    static Totals frameTotals(qint64 millis);
+
+    static int roundedIndex(TimeRoundingMode mode, int minutes);
+
+    void addToCells(const Frame *frame, int sign);
+
+    TomControl *_control;
+    FrameStore *_frames;
+
+    // project id -> start day -> totals of the stopped frames
+    QHash<QString, QMap<QDate, Cell>> _cells;
+};
+
+#endif //TOM_UI_ROLLUPCUBE_H
@@ -0,0 +1,216 @@
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QTextStream>
+#include <QtConcurrent/QtConcurrent>
+
+#include "StartupOrchestrator.h"
+
+StartupOrchestrator::StartupOrchestrator(const QElapsedTimer &clock, bool trace, QObject *parent) : QObject(parent),
+                                                                                                   _clock(clock),
+                                                                                                   _trace(trace),
+                                                                                                   _control(nullptr),
+                                                                                                   _statusManager(nullptr),
+                                                                                                   _framesWatcher(new QFutureWatcher<LoadedFrames>(this)),
+                                                                                                   _framesApplied(false) {
+    // each of the commands has its own thread, another one waits for them to revalidate the snapshot
+    _pool.setMaxThreadCount(5);
+    connect(_framesWatcher, &QFutureWatcher<LoadedFrames>::finished, this, &StartupOrchestrator::onFramesLoaded);
+}
+
+StartupOrchestrator::~StartupOrchestrator() {
+    _pool.waitForDone();
+    if (!_framesApplied && _frames.isFinished() && _frames.resultCount() > 0) {
+        qDeleteAll(_frames.result().frames);
+    }
+}
+
+void StartupOrchestrator::start(TomControl *control, bool loadFrames) {
+    _control = control;
+    mark("starting tom commands");
+
+    _version = startStep<CommandStatus>("tom --version", [control] {
+        return control->version();
+    });
+    _projects = startStep<QList<Project>>("tom projects", [control] {
+        return control->fetchProjects();
+    });
+    _status = startStep<TomStatus>("tom status", [control] {
+        TomStatus status;
+        control->fetchStatus(status);
+        return status;
+    });
+
+    if (loadFrames) {
+        // the frames include the archived frames, the status manager filters them
+        // they're streamed without the timeout of the other commands, large data takes longer than that
+        _frames = startStep<LoadedFrames>("tom frames", [control] {
+            LoadedFrames loaded;
+            loaded.complete = control->streamFrames("", true, true, [&loaded](Frame &frame) {
+                loaded.frames << new Frame(frame);
+                return true;
+            });
+            return loaded;
+        });
+        _framesWatcher->setFuture(_frames);
+    }
+
+    if (_trace) {
+        // the task is due with the other tasks of one minute and doesn't add a wakeup of its own
+        RefreshScheduler *scheduler = control->scheduler();
+        scheduler->addTask("wakeup trace", 60 * 1000, RefreshScheduler::BackgroundTask, this, [scheduler] {
+            qInfo().noquote() << "refresh wakeups during the last minute:" << scheduler->wakeupsPerMinute()
+                              << (scheduler->isUserIdle() ? "(user idle)" : "");
+        });
+    }
+}
+
+CommandStatus StartupOrchestrator::waitForVersion() {
+    return waitFor("waiting for the version", _version);
+}
+
+void StartupOrchestrator::waitForProjects() {
+    const QList<Project> &projects = waitFor("waiting for the projects", _projects);
+    const TomStatus &status = waitFor("waiting for the status", _status);
+
+    _control->setStartupData(projects, status);
+    mark("projects and status available");
+}
+
+void StartupOrchestrator::revalidate() {
+    auto *watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher] {
+        watcher->deleteLater();
+        onRevalidated();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&_pool, [this] {
+        const qint64 start = _clock.elapsed();
+        _version.waitForFinished();
+        _projects.waitForFinished();
+        _status.waitForFinished();
+        record("waiting for the projects to revalidate the snapshot", start, _clock.elapsed());
+    }));
+}
+
+void StartupOrchestrator::loadFramesInto(ProjectStatusManager *statusManager) {
+    _statusManager = statusManager;
+    if (_frames.isFinished() && !_framesApplied) {
+        onFramesLoaded();
+    }
+}
+
+void StartupOrchestrator::mark(const QString &event) {
+    const qint64 now = _clock.elapsed();
+    record(event, now, now);
+}
+
+QString StartupOrchestrator::timeline() const {
+    QMutexLocker lock(&_eventsMutex);
+    QVector<Event> events = _events;
+    lock.unlock();
+
+    std::stable_sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+        return a.start < b.start;
+    });
+
+    QString result;
+    QTextStream out(&result);
+    out << "startup timeline (start, duration, step):\n";
+    for (const auto &event : events) {
+        out << qSetFieldWidth(7) << event.start << qSetFieldWidth(0) << " ms";
+        if (event.end > event.start) {
+            out << qSetFieldWidth(7) << (event.end - event.start) << qSetFieldWidth(0) << " ms  ";
+        } else {
+            out << "           ";
+        }
+        out << event.name << "\n";
+    }
+    return result;
+}
+
+template<typename T>
+QFuture<T> StartupOrchestrator::startStep(const QString &name, const std::function<T()> &step) {
+    return QtConcurrent::run(&_pool, [this, name, step] {
+        const qint64 start = _clock.elapsed();
+        T result = step();
+        record(name, start, _clock.elapsed());
+        return result;
+    });
+}
+
+template<typename T>
+T StartupOrchestrator::waitFor(const QString &name, QFuture<T> &future) {
+    const qint64 start = _clock.elapsed();
+    future.waitForFinished();
+    record(name, start, _clock.elapsed());
+    return future.result();
+}
+
+void StartupOrchestrator::record(const QString &name, qint64 start, qint64 end) {
+    QMutexLocker lock(&_eventsMutex);
+    _events.append(Event{start, end, name});
+}
+
+void StartupOrchestrator::onRevalidated() {
+    if (_version.result().isFailed()) {
+        emit tomFailed();
+        return;
+    }
+
+    const QList<Project> &projects = _projects.result();
+    const bool changed = !isSameProjects(projects, _control->cachedProjects());
+    _control->setStartupData(projects, _status.result(), true);
+    mark(changed ? "snapshot replaced, the projects changed" : "snapshot revalidated");
+
+    if (changed) {
+        emit projectsChanged();
+    }
+}
+
+bool StartupOrchestrator::isSameProjects(const QList<Project> &a, const QList<Project> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    QHash<QString, Project> byID;
+    for (const auto &project : b) {
+        byID.insert(project.getID(), project);
+    }
+
+    // Project's operator== only compares the IDs
+    for (const auto &project : a) {
+        const Project &other = byID.value(project.getID());
+        if (!other.isValid() || project.getName() != other.getName() || project.getParentID() != other.getParentID()
+            || project.getHourlyRate() != other.getHourlyRate() || project.isNoteRequired() != other.isNoteRequired()
+            || project.appliedIsNoteRequired() != other.appliedIsNoteRequired()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StartupOrchestrator::onFramesLoaded() {
+    // the status manager is created after the frames were requested
+    if (!_statusManager || _framesApplied || !_frames.isFinished() || _frames.resultCount() == 0) {
+        return;
+    }
+    _framesApplied = true;
+
+    const LoadedFrames &loaded = _frames.result();
+    if (loaded.complete) {
+        const qint64 start = _clock.elapsed();
+        _statusManager->loadFrames(loaded.frames);
+        _control->recentProjects()->setFrames(loaded.frames);
+        record("computing the status from the frames", start, _clock.elapsed());
+    } else {
+        // a partial list would display wrong totals
+        mark("loading the frames failed");
+    }
+    qDeleteAll(loaded.frames);
+
+    mark("startup complete");
+    if (_trace) {
+        QTextStream(stderr) << timeline();
+    }
+}
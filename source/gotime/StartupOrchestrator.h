@@ -0,0 +1,128 @@
+#ifndef TOM_UI_STARTUPORCHESTRATOR_H
+#define TOM_UI_STARTUPORCHESTRATOR_H
+
+#include <functional>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFuture>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include "TomControl.h"
+#include "ProjectStatusManager.h"
+
+/**
+ * Loads the data of the application at startup with a single call of each tom command.
+ * The commands are independent of each other and run concurrently. The main window is created as soon as the
+ * projects and the status are available, the frames are passed to the status manager when they're loaded.
+ * With a startup snapshot the window is created without waiting, the results of the commands replace the data of the
+ * snapshot when they're available.
+ * All steps are recorded in a timeline, which is printed to stderr with --startup-trace.
+ * The trace also logs the wakeups of the refresh scheduler once per minute while the application is running.
+ */
+class StartupOrchestrator : public QObject {
+Q_OBJECT
+
+public:
+    /**
+     * @param clock Started when the application was launched, the times of the timeline are relative to it.
+     */
+    StartupOrchestrator(const QElapsedTimer &clock, bool trace, QObject *parent = nullptr);
+
+    ~StartupOrchestrator() override;
+
+    /**
+     * Starts all commands in the background.
+     * @param loadFrames false if the frames are not needed, e.g. when the application is used on the command line.
+     */
+    void start(TomControl *control, bool loadFrames);
+
+    /**
+     * Blocks until tom's version was read.
+     */
+    CommandStatus waitForVersion();
+
+    /**
+     * Blocks until the projects and the status were loaded and passes them to the control.
+     */
+    void waitForProjects();
+
+    /**
+     * Compares the projects and the status of the startup snapshot, which were passed to the control, with tom's data
+     * as soon as the commands finished, without blocking. The control is updated with tom's data.
+     */
+    void revalidate();
+
+    /**
+     * Passes the frames to the status manager as soon as they're loaded, without blocking.
+     * Frames which couldn't be loaded completely are dropped, the status is then read from tom's status command.
+     */
+    void loadFramesInto(ProjectStatusManager *statusManager);
+
+    /**
+     * Adds an event of the application to the timeline.
+     */
+    void mark(const QString &event);
+
+    QString timeline() const;
+
+signals:
+
+    /**
+     * Emitted by revalidate() if tom is not working.
+     */
+    void tomFailed();
+
+    /**
+     * Emitted by revalidate() if tom's projects differ from the projects of the snapshot.
+     */
+    void projectsChanged();
+
+private:
+    struct LoadedFrames {
+        QList<Frame *> frames;
+        // false if tom failed or its output was truncated
+        bool complete = false;
+    };
+
+    struct Event {
+        qint64 start;
+        qint64 end;
+        QString name;
+    };
+
+    template<typename T>
+    QFuture<T> startStep(const QString &name, const std::function<T()> &step);
+
+    template<typename T>
+    T waitFor(const QString &name, QFuture<T> &future);
+
+    void record(const QString &name, qint64 start, qint64 end);
+
+    void onFramesLoaded();
+
+    void onRevalidated();
+
+    static bool isSameProjects(const QList<Project> &a, const QList<Project> &b);
+
+    QElapsedTimer _clock;
+    bool _trace;
+    TomControl *_control;
+    ProjectStatusManager *_statusManager;
+
+    QThreadPool _pool;
+    QFuture<CommandStatus> _version;
+    QFuture<QList<Project>> _projects;
+    QFuture<TomStatus> _status;
+    QFuture<LoadedFrames> _frames;
+    QFutureWatcher<LoadedFrames> *_framesWatcher;
+    bool _framesApplied;
+
+    mutable QMutex _eventsMutex;
+    QVector<Event> _events;
+};
+
+#endif //TOM_UI_STARTUPORCHESTRATOR_H
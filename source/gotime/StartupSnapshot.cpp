@@ -0,0 +1,102 @@
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include "StartupSnapshot.h"
+
+static const quint32 FILE_MAGIC = 0x746f6d73;
+static const quint32 FILE_VERSION = 2;
+
+StartupSnapshot::StartupSnapshot(const QString &configName, const QString &tomPath) : _key(configName + '\n' + tomPath) {
+    const QString &cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheDir.isEmpty()) {
+        const QByteArray &hash = QCryptographicHash::hash(_key.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+        _fileName = cacheDir + "/snapshot-" + QString::fromLatin1(hash) + ".dat";
+    }
+}
+
+QString StartupSnapshot::fileName() const {
+    return _fileName;
+}
+
+bool StartupSnapshot::read() {
+    QFile file(_fileName);
+    if (_fileName.isEmpty() || !file.open(QIODevice::ReadOnly) || file.size() == 0) {
+        return false;
+    }
+
+    // the file is mapped instead of read, only the pages which are needed are loaded
+    uchar *mapped = file.map(0, file.size());
+    if (!mapped) {
+        qWarning() << "unable to map snapshot file" << _fileName;
+        return false;
+    }
+
+    const QByteArray &data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), static_cast<int>(file.size()));
+    QDataStream in(data);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != FILE_MAGIC || version != FILE_VERSION) {
+        return false;
+    }
+    in.setVersion(QDataStream::Qt_5_9);
+
+    QString key;
+    in >> key;
+    if (key != _key) {
+        return false;
+    }
+
+    QList<Project> projects;
+    TomStatus status;
+    QHash<QString, ProjectStatus> projectsStatus;
+    bool hasFrames = false;
+    QString framesProjectID;
+    bool framesArchived = false;
+    QList<Frame> frames;
+    in >> projects >> status >> projectsStatus
+       >> hasFrames >> framesProjectID >> framesArchived >> frames;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "unable to read snapshot file" << _fileName;
+        return false;
+    }
+
+    this->projects = projects;
+    this->status = status;
+    this->projectsStatus = ProjectsStatus(projectsStatus);
+    hasSelectedFrames = hasFrames;
+    selectedProjectID = framesProjectID;
+    selectedFramesArchived = framesArchived;
+    selectedFrames = frames;
+    return true;
+}
+
+bool StartupSnapshot::write() const {
+    if (_fileName.isEmpty()) {
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(_fileName).absolutePath());
+    QSaveFile file(_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "unable to write snapshot file" << _fileName;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << FILE_MAGIC << FILE_VERSION;
+    out.setVersion(QDataStream::Qt_5_9);
+    out << _key << projects << status << projectsStatus.getMapping()
+        << hasSelectedFrames << selectedProjectID << selectedFramesArchived << selectedFrames;
+    if (!file.commit()) {
+        qWarning() << "unable to write snapshot file" << _fileName;
+        return false;
+    }
+    return true;
+}
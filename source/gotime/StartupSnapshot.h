@@ -0,0 +1,46 @@
+#ifndef TOM_UI_STARTUPSNAPSHOT_H
+#define TOM_UI_STARTUPSNAPSHOT_H
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include "data/Frame.h"
+#include "data/Project.h"
+#include "ProjectStatus.h"
+#include "TomStatus.h"
+
+/**
+ * The data displayed right after startup, which is saved when the application quits and periodically.
+ * At startup the snapshot is displayed until tom's current data was loaded in the background.
+ * There's a file for each combination of the configuration name and the tom executable.
+ */
+class StartupSnapshot {
+public:
+    StartupSnapshot(const QString &configName, const QString &tomPath);
+
+    /**
+     * Reads the snapshot file, the data is left empty if the file is missing or of another version.
+     * @return true if the data was read.
+     */
+    bool read();
+
+    bool write() const;
+
+    QString fileName() const;
+
+    QList<Project> projects;
+    TomStatus status;
+    ProjectsStatus projectsStatus;
+
+    // the frames of the selected project, as displayed in the frame table
+    bool hasSelectedFrames = false;
+    QString selectedProjectID;
+    bool selectedFramesArchived = false;
+    QList<Frame> selectedFrames;
+
+private:
+    QString _key;
+    QString _fileName;
+};
+
+#endif //TOM_UI_STARTUPSNAPSHOT_H
@@ -1,21 +1,51 @@
 #include <utility>
 
 #include <QtCore/QProcess>
+#include <QtCore/QRegularExpression>
 
 #include "TomControl.h"
+#include "TomOutputParser.h"
 
 TomControl::TomControl(QString gotimePath, bool bashScript, QObject *parent) : QObject(parent),
                                                                                _gotimePath(std::move(gotimePath)),
-                                                                               _bashScript(bashScript) {
-
-    loadProjects();
-    refreshProjectStatus();
-
-    auto *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, [this] {
+                                                                               _scheduler(new RefreshScheduler(this)),
+                                                                               _recentProjects(new RecentProjects(this)),
+                                                                               _bashScript(bashScript),
+                                                                               _dataGeneration(0) {
+    // the initial data is loaded by the StartupOrchestrator
+    connect(this, &TomControl::framesUpdated, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::framesRemoved, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::framesMoved, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::framesArchived, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::projectFramesArchived, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::projectCreated, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::projectUpdated, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::projectRemoved, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::projectHierarchyChanged, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::projectStatusChanged, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::dataResetNeeded, this, &TomControl::markDataChanged);
+    connect(this, &TomControl::projectStatusChanged, _recentProjects, &RecentProjects::onProjectStatusChanged);
+
+    // the status may be changed by other tom clients
+    _scheduler->addTask("tom status", 30 * 1000, RefreshScheduler::BackgroundTask, this, [this] {
         refreshProjectStatus();
     });
-    timer->start(30 * 1000);
+}
+
+RefreshScheduler *TomControl::scheduler() const {
+    return _scheduler;
+}
+
+RecentProjects *TomControl::recentProjects() const {
+    return _recentProjects;
+}
+
+quint64 TomControl::dataGeneration() const {
+    return _dataGeneration;
+}
+
+void TomControl::markDataChanged() {
+    _dataGeneration++;
 }
 
 void TomControl::cacheProjects(const QList<Project> &projects) {
@@ -24,13 +54,45 @@ void TomControl::cacheProjects(const QList<Project> &projects) {
     for (const auto &project : projects) {
         _cachedProjects[project.getID()] = project;
     }
+    emit projectsCached();
 }
 
 QList<Project> TomControl::cachedRecentProjects() const {
-    return _cachedRecentProjects;
+    // projects which were removed are skipped
+    QList<Project> result;
+    const int maxCount = _recentProjects->maxCount();
+    for (const auto &id : _recentProjects->projectIDs()) {
+        if (result.size() >= maxCount) {
+            break;
+        }
+
+        const Project &project = cachedProject(id);
+        if (project.isValid()) {
+            result << project;
+        }
+    }
+    return result;
+}
+
+void TomControl::setStartupData(const QList<Project> &projects, const TomStatus &status, bool emitStatusChange) {
+    cacheProjects(projects);
+
+    const TomStatus previous = _cachedStatus;
+    _cachedStatus = status;
+    if (emitStatusChange && previous != status) {
+        emit projectStatusChanged(status.currentProject(), previous.currentProject());
+    }
 }
 
 QList<Project> TomControl::loadProjects(int max) {
+    const QList<Project> &result = fetchProjects(max);
+    if (max <= 0) {
+        cacheProjects(result);
+    }
+    return result;
+}
+
+QList<Project> TomControl::fetchProjects(int max) const {
     QStringList args = QStringList() << "projects"
                                      << "--name-delimiter=||"
                                      << "-f"
@@ -39,45 +101,11 @@ QList<Project> TomControl::loadProjects(int max) {
         args << "--recent" << QString::number(max);
     }
 
-    CommandStatus status = run(args);
+    const CommandStatus &status = execute(args);
     if (status.isFailed()) {
         return QList<Project>();
     }
-
-    QStringList lines = status.stdoutContent.split("\n", QString::SkipEmptyParts);
-    QList<Project> result;
-    for (const auto &line : lines) {
-        QStringList lineItems = line.split("\t");
-        if (lineItems.size() == 6) {
-            const auto &names = lineItems.at(0).split("||");
-            const auto &id = lineItems.at(1);
-            const auto &parent = lineItems.at(2);
-            const auto &hourlyRate = lineItems.at(3);
-            const auto &noteRequired = lineItems.at(4);
-            const auto &noteRequiredInherited = lineItems.at(5);
-
-            TriState noteRequiredValue;
-            if (noteRequired == "true") {
-                noteRequiredValue = TRUE;
-            } else if (noteRequired == "false") {
-                noteRequiredValue = FALSE;
-            } else {
-                noteRequiredValue = UNDEFINED;
-                if (noteRequired != "") {
-                    qWarning() << "invalid value found for noteRequired:" << noteRequired;
-                }
-            }
-
-            const bool noteRequiredInheritedValue = noteRequiredInherited == "true";
-
-            result.append(Project(names, id, parent, hourlyRate, noteRequiredValue, noteRequiredInheritedValue));
-        }
-    }
-
-    if (max <= 0) {
-        cacheProjects(result);
-    }
-    return result;
+    return TomOutputParser::parseProjects(status.stdoutContent);
 }
 
 bool TomControl::isStarted(const Project &project, bool includeSubprojects) {
@@ -140,17 +168,32 @@ TomStatus TomControl::cachedStatus() {
 }
 
 void TomControl::refreshProjectStatus(bool emitProjectStatusChanged) {
-    loadRecentProjects();
     status(emitProjectStatusChanged);
 }
 
 TomStatus TomControl::status(bool emitProjectStatusChanged) {
-    TomStatus currentStatus = TomStatus();
+    TomStatus currentStatus;
+    if (!fetchStatus(currentStatus)) {
+        return TomStatus();
+    }
+
+    TomStatus prevStatus = _cachedStatus;
+    _cachedStatus = currentStatus;
+
+    if (emitProjectStatusChanged && prevStatus != _cachedStatus) {
+        emit projectStatusChanged(_cachedStatus.currentProject(), prevStatus.currentProject());
+    }
+
+    return currentStatus;
+}
+
+bool TomControl::fetchStatus(TomStatus &currentStatus) const {
+    currentStatus = TomStatus();
 
     QStringList args = QStringList() << "status"
                                      << "--name-delimiter=||"
                                      << "-f" << "id,projectFullName,projectID,projectParentID,startTime";
-    CommandStatus status = run(args);
+    const CommandStatus &status = execute(args);
     if (status.isSuccessful()) {
         // fixme atm we omly support a single active project
         QStringList lines = status.stdoutContent.split("\n", QString::SkipEmptyParts);
@@ -158,7 +201,7 @@ TomStatus TomControl::status(bool emitProjectStatusChanged) {
             QStringList parts = lines.first().split("\t");
             if (parts.size() != 5) {
                 qWarning() << "unexpected status line" << lines.first();
-                return TomStatus();
+                return false;
             }
 
             const QString &timeEntryId = parts[0];
@@ -171,18 +214,10 @@ TomStatus TomControl::status(bool emitProjectStatusChanged) {
             currentStatus = TomStatus(true, timeEntryId, project, startTime);
         }
     }
-
-    TomStatus prevStatus = _cachedStatus;
-    _cachedStatus = currentStatus;
-
-    if (emitProjectStatusChanged && prevStatus != _cachedStatus) {
-        emit projectStatusChanged(_cachedStatus.currentProject(), prevStatus.currentProject());
-    }
-
-    return currentStatus;
+    return true;
 }
 
-QList<Frame *> TomControl::loadFrames(const QString &projectID, bool includeSubprojects, bool includeArchived) {
+QStringList TomControl::framesArguments(const QString &projectID, bool includeSubprojects, bool includeArchived) {
     QStringList args = QStringList() << "frames"
                                      << "-o" << "json"
                                      << "-p" << projectID
@@ -193,8 +228,11 @@ QList<Frame *> TomControl::loadFrames(const QString &projectID, bool includeSubp
     }
 
     args.append(QString("--archived=%1").arg(includeArchived ? "true" : "false"));
+    return args;
+}
 
-    const CommandStatus &resp = run(args);
+QList<Frame *> TomControl::loadFrames(const QString &projectID, bool includeSubprojects, bool includeArchived) const {
+    const CommandStatus &resp = execute(framesArguments(projectID, includeSubprojects, includeArchived));
     if (resp.isFailed()) {
         qDebug() << "frame command failed";
         return QList<Frame *>();
@@ -205,40 +243,68 @@ QList<Frame *> TomControl::loadFrames(const QString &projectID, bool includeSubp
         return QList<Frame *>();
     }
 
-    QJsonParseError err = QJsonParseError();
-    QJsonDocument json = QJsonDocument::fromJson(stdout, &err);
-    if (err.error != QJsonParseError::NoError) {
-        qWarning() << "json parse error" << err.errorString();
-        return QList<Frame *>();
+    // fixme who's deleting the allocated data?
+    return TomOutputParser::parseFrames(stdout);
+}
+
+bool TomControl::streamFrames(const QString &projectID, bool includeSubprojects, bool includeArchived,
+                              const std::function<bool(Frame &)> &callback) const {
+    if (_gotimePath.isEmpty()) {
+        return false;
     }
 
-    QList<Frame *> result;
-    if (!json.isArray()) {
-        return result;
+    const QStringList &args = framesArguments(projectID, includeSubprojects, includeArchived);
+    qDebug() << "streaming" << _gotimePath << args;
+
+    // no parent, this may run on another thread
+    QProcess process;
+    if (_bashScript) {
+        // fixme fix path to bash
+        process.start("/usr/bin/bash", QStringList() << _gotimePath << args);
+    } else {
+        process.start(_gotimePath, args);
+    }
+    if (!process.waitForStarted()) {
+        qWarning() << "unable to start frames command";
+        return false;
     }
 
-    const QJsonArray &items = json.array();
+    FrameStreamParser parser;
+    bool hasOutput = false;
+    forever {
+        const bool ready = process.waitForReadyRead(60 * 1000);
+        if (!ready && process.state() != QProcess::NotRunning) {
+            qWarning() << "timeout while reading frames";
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+
+        const QByteArray &chunk = process.readAllStandardOutput();
+        hasOutput |= !chunk.isEmpty();
+        if (!chunk.isEmpty() && !parser.feed(chunk, callback)) {
+            // stopped by the callback or invalid output
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
 
-    for (const auto &arrayItem: items) {
-        if (!arrayItem.isObject()) {
-            qDebug() << "item not an object" << arrayItem;
+        if (!ready && process.bytesAvailable() == 0) {
             break;
         }
+    }
 
-        const QJsonObject &item = arrayItem.toObject();
-        const QString id = item["id"].toString();
-        const QString nestedProjectID = item["projectID"].toString();
-        const QDateTime start = QDateTime::fromString(item["startTime"].toString(), Qt::ISODate);
-        const QDateTime end = QDateTime::fromString(item["stopTime"].toString(), Qt::ISODate);
-        const QDateTime lastUpdated = QDateTime::fromString(item["lastUpdated"].toString(), Qt::ISODate);
-        const QString notes = item["notes"].toString("");
-        const QStringList tags = QStringList(); // fixme
-        const bool archived = item["archived"].toBool(false);
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        qDebug() << "frames command failed:" << process.readAllStandardError();
+        return false;
+    }
 
-        // fixme who's deleting the allocated data?
-        result.append(new Frame(id, nestedProjectID, start, end, lastUpdated, notes, tags, archived));
+    // an empty output is an empty list, otherwise the array must be complete
+    if (hasOutput && !parser.isFinished()) {
+        qWarning() << "incomplete output of the frames command";
+        return false;
     }
-    return result;
+    return true;
 }
 
 bool TomControl::renameProject(const QString &id, const QString &newName) {
@@ -311,6 +377,9 @@ bool TomControl::updateFrames(const QStringList &ids, const QStringList &project
         if (updateArchived) {
             emit framesArchived(ids, projectIDs, archived);
         }
+        if (updateStart || updateEnd) {
+            emit frameTimesUpdated(ids, updateStart ? start : QDateTime(), updateEnd ? end : QDateTime());
+        }
 
         emit framesUpdated(ids, projectIDs);
 
@@ -375,7 +444,7 @@ bool TomControl::updateProjects(const QStringList &ids, bool updateName, const Q
     return success;
 }
 
-ProjectsStatus TomControl::projectsStatus(const QString &overallID, bool includeActive, bool includeArchived) {
+ProjectsStatus TomControl::projectsStatus(const QString &overallID, bool includeActive, bool includeArchived) const {
     QString idList = "id,trackedDay,totalTrackedDay,trackedYesterday,totalTrackedYesterday,trackedWeek,totalTrackedWeek,trackedMonth,totalTrackedMonth,trackedYear,totalTrackedYear,trackedAll,totalTrackedAll";
     const int expectedColumns = idList.count(',') + 1;
 
@@ -389,49 +458,13 @@ ProjectsStatus TomControl::projectsStatus(const QString &overallID, bool include
     }
     args << QString("--archived=%1").arg(includeArchived ? "true" : "false");
 
-    CommandStatus cmdStatus = run(args);
+    // the status doesn't modify tom's data
+    CommandStatus cmdStatus = execute(args);
     if (cmdStatus.isFailed()) {
         return ProjectsStatus();
     }
 
-    auto mapping = QHash<QString, ProjectStatus>();
-
-    QStringList lines = cmdStatus.stdoutContent.split("\n", QString::SkipEmptyParts);
-    for (const auto &line : lines) {
-        QStringList parts = line.split("\t");
-        if (parts.size() != expectedColumns) {
-            qDebug() << "unexpected number of columns in" << line;
-            continue;
-        }
-
-        QString id = parts.takeFirst();
-
-        Timespan day = Timespan(parts.takeFirst().toLongLong());
-        Timespan dayTotal = Timespan(parts.takeFirst().toLongLong());
-
-        Timespan yesterday = Timespan(parts.takeFirst().toLongLong());
-        Timespan yesterdayTotal = Timespan(parts.takeFirst().toLongLong());
-
-        Timespan week = Timespan(parts.takeFirst().toLongLong());
-        Timespan weekTotal = Timespan(parts.takeFirst().toLongLong());
-
-        Timespan month = Timespan(parts.takeFirst().toLongLong());
-        Timespan monthTotal = Timespan(parts.takeFirst().toLongLong());
-
-        Timespan year = Timespan(parts.takeFirst().toLongLong());
-        Timespan yearTotal = Timespan(parts.takeFirst().toLongLong());
-
-        Timespan all = Timespan(parts.takeFirst().toLongLong());
-        Timespan allTotal = Timespan(parts.takeFirst().toLongLong());
-
-        mapping.insert(id, ProjectStatus(id, all, allTotal,
-                                         year, yearTotal,
-                                         month, monthTotal,
-                                         week, weekTotal,
-                                         yesterday, yesterdayTotal,
-                                         day, dayTotal));
-    }
-
+    const auto &mapping = TomOutputParser::parseProjectsStatus(cmdStatus.stdoutContent, expectedColumns);
     return ProjectsStatus(mapping);
 }
 
@@ -545,9 +578,9 @@ void TomControl::resetAll() {
     }
 }
 
-//QList<Project> TomControl::cachedProjects() const {
-//    return _cachedProjects.values();
-//}
+QList<Project> TomControl::cachedProjects() const {
+    return _cachedProjects.values();
+}
 
 Project TomControl::cachedProject(const QString &id) const {
     return _cachedProjects.value(id);
@@ -609,71 +642,73 @@ QStringList TomControl::projectIDs(const QString &projectID, bool includeSubproj
     return ids;
 }
 
-QString TomControl::htmlReport(const QString &outputFile,
-                               const QStringList &projectIDs,
-                               bool includeSubprojects,
-                               QDate start, QDate end,
-                               TimeRoundingMode frameRoundingMode, int frameRoundingMinutes,
-                               const QStringList &splits,
-                               const QString &templateID,
-                               bool matrixTables,
-                               bool showEmpty,
-                               bool showSummary,
-                               bool includeArchived,
-                               const QString &title, const QString &description,
-                               bool showSales,
-                               bool showTracked, bool showUntracked,
-                               const QString &cssFile,
-                               bool decimalTimeFormat) {
+QString TomControl::htmlReport(const QString &outputFile, const ReportOptions &options) {
+    const auto &status = run(reportArguments(outputFile, options), 5000);
+    return status.stdoutContent;
+}
+
+ReportProcess *TomControl::startHtmlReport(const QString &outputFile, const ReportOptions &options, QObject *parent) {
+    const QStringList &args = reportArguments(outputFile, options);
+    qDebug() << "starting report" << _gotimePath << args;
+
+    // the report doesn't modify data, it's not synchronized with the other commands
+    if (_bashScript) {
+        // fixme fix path to bash
+        return new ReportProcess("/usr/bin/bash", QStringList() << _gotimePath << args, 60 * 1000, parent);
+    }
+    return new ReportProcess(_gotimePath, args, 60 * 1000, parent);
+}
+
+QStringList TomControl::reportArguments(const QString &outputFile, const ReportOptions &options) const {
     QStringList args;
     args << "report";
     if (!outputFile.isEmpty()) {
         args << QString("--output-file=%1").arg(outputFile);
     }
-    args << "--split=" + splits.join(",");
+    args << "--split=" + options.splits.join(",");
 
-    if (!projectIDs.isEmpty()) {
-        for (const auto &id : projectIDs) {
+    if (!options.projectIDs.isEmpty()) {
+        for (const auto &id : options.projectIDs) {
             args << "--project=" + id;
         }
     }
 
-    args << QString("--subprojects=%1").arg(includeSubprojects ? "true" : "false");
+    args << QString("--subprojects=%1").arg(options.includeSubprojects ? "true" : "false");
 
-    if (!templateID.isEmpty()) {
-        args << "--template=" + templateID;
+    if (!options.templateID.isEmpty()) {
+        args << "--template=" + options.templateID;
     }
 
-    if (start.isValid() && !start.isNull()) {
-        QDateTime startDate = QDateTime(start);
+    if (options.start.isValid()) {
+        QDateTime startDate = QDateTime(options.start);
         startDate.setTime(QTime(0, 0, 0, 0));
         args << "--from=" + startDate.toTimeSpec(Qt::OffsetFromUTC).toString(Qt::ISODate);
     }
 
-    if (end.isValid() && !end.isNull()) {
-        QDateTime endDate = QDateTime(end);
+    if (options.end.isValid()) {
+        QDateTime endDate = QDateTime(options.end);
         endDate.setTime(QTime(23, 59, 50, 999));
         args << "--to=" + endDate.toTimeSpec(Qt::OffsetFromUTC).toString(Qt::ISODate);
     }
 
-    args << QString("--matrix-tables=%1").arg(matrixTables ? "true" : "false");
-    args << QString("--show-empty=%1").arg(showEmpty ? "true" : "false");
-    args << QString("--show-summary=%1").arg(showSummary ? "true" : "false");
-    args << QString("--include-archived=%1").arg(includeArchived ? "true" : "false");
-    args << QString("--show-sales=%1").arg(showSales ? "true" : "false");
-    args << QString("--show-tracked=%1").arg(showTracked ? "true" : "false");
-    args << QString("--show-untracked=%1").arg(showUntracked ? "true" : "false");
-    args << QString("--decimal=%1").arg(decimalTimeFormat ? "true" : "false");
+    args << QString("--matrix-tables=%1").arg(options.matrixTables ? "true" : "false");
+    args << QString("--show-empty=%1").arg(options.showEmpty ? "true" : "false");
+    args << QString("--show-summary=%1").arg(options.showSummary ? "true" : "false");
+    args << QString("--include-archived=%1").arg(options.includeArchived ? "true" : "false");
+    args << QString("--show-sales=%1").arg(options.showSales ? "true" : "false");
+    args << QString("--show-tracked=%1").arg(options.showTracked ? "true" : "false");
+    args << QString("--show-untracked=%1").arg(options.showUntracked ? "true" : "false");
+    args << QString("--decimal=%1").arg(options.decimalTimeFormat ? "true" : "false");
 
-    if (!title.isEmpty()) {
-        args << "--title=" + title;
+    if (!options.title.isEmpty()) {
+        args << "--title=" + options.title;
     }
 
-    if (!description.isEmpty()) {
-        args << "--description=" + description;
+    if (!options.description.isEmpty()) {
+        args << "--description=" + options.description;
     }
 
-    switch (frameRoundingMode) {
+    switch (options.frameRoundingMode) {
         case NONE:
             break;
         case NEAREST:
@@ -686,19 +721,33 @@ QString TomControl::htmlReport(const QString &outputFile,
             break;
     }
 
-    if (frameRoundingMode == NONE) {
+    if (options.frameRoundingMode == NONE) {
         args << "--round-frames-to" << "0m";
     } else {
-        args << "--round-frames-to" << QString("%1m").arg(frameRoundingMinutes);
+        args << "--round-frames-to" << QString("%1m").arg(options.frameRoundingMinutes);
     }
 
-    if (!cssFile.isEmpty()) {
-        args << "--css-file=" + cssFile;
+    if (!options.cssFile.isEmpty()) {
+        args << "--css-file=" + options.cssFile;
     }
 
-    const auto &status = run(args, 5000);
+    return args;
+}
+
+double TomControl::appliedHourlyRate(const QString &projectID) const {
+    // the rate is a number followed by the currency, e.g. "42.50 EUR"
+    static const QRegularExpression number("[0-9]+([.,][0-9]+)?");
 
-    return status.stdoutContent;
+    QString id = projectID;
+    for (int depth = 0; !id.isEmpty() && depth < 64; depth++) {
+        const Project &project = _cachedProjects.value(id);
+        const QRegularExpressionMatch &match = number.match(project.getHourlyRate());
+        if (match.hasMatch()) {
+            return match.captured(0).replace(',', '.').toDouble();
+        }
+        id = project.getParentID();
+    }
+    return 0;
 }
 
 const Project &TomControl::cachedActiveProject() const {
@@ -738,19 +787,23 @@ void TomControl::archiveProjectFrames(const Project &project, bool includeSubpro
 }
 
 CommandStatus TomControl::run(const QStringList &args, long timeoutMillis) {
+    QMutexLocker lock(&_mutex);
+    return execute(args, timeoutMillis);
+}
+
+CommandStatus TomControl::execute(const QStringList &args, long timeoutMillis) const {
     if (_gotimePath.isEmpty()) {
         return CommandStatus("", "executable name is empty", -1);
     }
 
-    QMutexLocker lock(&_mutex);
-
     auto start = QDateTime::currentDateTime().toMSecsSinceEpoch();
     if (args.first() != "status") {
         qDebug() << "running" << _gotimePath;
         qDebug() << "running" << _gotimePath << args;
     }
 
-    QProcess process(this);
+    // no parent, this may run on another thread
+    QProcess process;
     if (_bashScript) {
         // fixme fix path to bash
         process.start("/usr/bin/bash", QStringList() << _gotimePath << args);
@@ -771,14 +824,8 @@ CommandStatus TomControl::run(const QStringList &args, long timeoutMillis) {
     return CommandStatus(output, errOutput, process.exitCode());
 }
 
-QList<Project> TomControl::loadRecentProjects() {
-    // fixme make number of recent projects configurable?
-    _cachedRecentProjects = loadProjects(5);
-    return _cachedRecentProjects;
-}
-
-CommandStatus TomControl::version() {
-    return run(QStringList() << "--version");
+CommandStatus TomControl::version() const {
+    return execute(QStringList() << "--version");
 }
 
 void TomControl::resetCache() {
@@ -9,10 +9,10 @@
 #include "CommandStatus.h"
 #include "TomStatus.h"
 #include "ProjectStatus.h"
-
-enum TimeRoundingMode {
-    NONE, UP, NEAREST, DOWN
-};
+#include "RecentProjects.h"
+#include "RefreshScheduler.h"
+#include "ReportOptions.h"
+#include "ReportProcess.h"
 
 class TomControl : public QObject {
 Q_OBJECT
@@ -20,7 +20,33 @@ Q_OBJECT
 public:
     explicit TomControl(QString gotimePath, bool bashScript, QObject *parent);
 
-    CommandStatus version();
+    CommandStatus version() const;
+
+    /**
+     * Sets the data, which was loaded concurrently at startup or read from the startup snapshot.
+     * @param emitStatusChange true if projectStatusChanged() is emitted when the status differs from the cached status.
+     */
+    void setStartupData(const QList<Project> &projects, const TomStatus &status, bool emitStatusChange = false);
+
+    /**
+     * @return The scheduler which runs all periodic refreshes of the application.
+     */
+    RefreshScheduler *scheduler() const;
+
+    /**
+     * @return The frecency of the projects, which defines the recent projects.
+     */
+    RecentProjects *recentProjects() const;
+
+    /**
+     * @return A number which changes whenever projects or frames were modified.
+     */
+    quint64 dataGeneration() const;
+
+    /**
+     * Marks the data as modified, e.g. when a modification by another tom client was detected.
+     */
+    void markDataChanged();
 
     /**
      * Create a new project.
@@ -31,27 +57,59 @@ public:
 
     QList<Project> loadProjects(int max = -1);
 
-    QList<Project> loadRecentProjects();
+    /**
+     * Loads the projects without caching them. This method may be called on any thread.
+     */
+    QList<Project> fetchProjects(int max = -1) const;
 
+    /**
+     * @return The most relevant projects of the frecency list, without calling tom.
+     */
     QList<Project> cachedRecentProjects() const;
 
-//    QList<Project> cachedProjects() const;
+    QList<Project> cachedProjects() const;
 
     Project cachedProject(const QString &id) const;
 
+    /**
+     * @return The hourly rate of the project, which is inherited from the nearest parent defining a rate. 0 if there's no rate.
+     */
+    double appliedHourlyRate(const QString &projectID) const;
+
     const Project& cachedActiveProject() const;
 
     bool hasSubprojects(const Project &project);
 
     TomStatus status(bool emitProjectStatusChanged = false);
 
+    /**
+     * Loads the status without caching it. This method may be called on any thread.
+     * @return false if tom's output was unexpected.
+     */
+    bool fetchStatus(TomStatus &status) const;
+
     TomStatus cachedStatus();
 
-    ProjectsStatus projectsStatus(const QString &overallID, bool includeActive, bool includeArchived);
+    /**
+     * Loads the tracked time of all projects. This method may be called on any thread.
+     */
+    ProjectsStatus projectsStatus(const QString &overallID, bool includeActive, bool includeArchived) const;
 
     bool isStarted(const Project &project, bool includeSubprojects = false);
 
-    QList<Frame *> loadFrames(const QString &projectID, bool includeSubprojects, bool includeArchived);
+    /**
+     * Loads the frames of a project. This method may be called on any thread.
+     */
+    QList<Frame *> loadFrames(const QString &projectID, bool includeSubprojects, bool includeArchived) const;
+
+    /**
+     * Reads the frames of a project while tom writes them and passes them one by one to the callback.
+     * The frames are not kept in memory. This method may be called on any thread.
+     * @param callback Returns false to stop reading.
+     * @return true if all frames were read successfully.
+     */
+    bool streamFrames(const QString &projectID, bool includeSubprojects, bool includeArchived,
+                      const std::function<bool(Frame &)> &callback) const;
 
     bool renameProject(const QString &id, const QString &newName);
 
@@ -99,23 +157,13 @@ public:
 
     bool isAnyParentProject(const QString &id, const QStringList &parents) const;
 
-    QString htmlReport(const QString &outputFile,
-                       const QStringList &projectIDs,
-                       bool includeSubprojects,
-                       QDate start, QDate end,
-                       TimeRoundingMode frameRoundingMode, int frameRoundingMinutes,
-                       const QStringList &splits,
-                       const QString &templateID,
-                       bool matrixTables,
-                       bool showEmpty,
-                       bool showSummary,
-                       bool includeArchived,
-                       const QString &title, const QString &description,
-                       bool showSales,
-                       bool showTracked, bool showUntracked,
-                       const QString &cssFile,
-                       bool decimalTimeFormat
-                       );
+    QString htmlReport(const QString &outputFile, const ReportOptions &options);
+
+    /**
+     * Starts to generate a HTML report without blocking the caller.
+     * @return The running report, it emits finished() with the HTML when it's done.
+     */
+    ReportProcess *startHtmlReport(const QString &outputFile, const ReportOptions &options, QObject *parent);
 
     QStringList projectIDs(const QString &projectID, bool includeSubprojects) const;
 
@@ -123,6 +171,11 @@ signals:
 
     void dataResetNeeded();
 
+    /**
+     * Emitted when all cached projects were replaced, e.g. by loadProjects() after dataResetNeeded() or at startup.
+     */
+    void projectsCached();
+
     void projectStatusChanged(const Project &started, const Project &stopped);
 
     void projectCreated(const Project &project);
@@ -135,6 +188,12 @@ signals:
 
     void projectFramesArchived(const QStringList &projectIDs);
 
+    /**
+     * Emitted before framesUpdated() when the start or the end of frames was modified.
+     * A time which wasn't modified is invalid.
+     */
+    void frameTimesUpdated(const QStringList &ids, const QDateTime &start, const QDateTime &end);
+
     void framesUpdated(const QStringList &ids, const QStringList &projectIDs);
 
     void framesRemoved(const QStringList &ids, const QStringList &projectIDs);
@@ -154,13 +213,24 @@ public slots:
 private:
     CommandStatus run(const QStringList &args, long timeoutMillis = 1000);
 
+    /**
+     * Runs a command without locking. Only used for commands which don't modify tom's data.
+     */
+    CommandStatus execute(const QStringList &args, long timeoutMillis = 1000) const;
+
+    static QStringList framesArguments(const QString &projectID, bool includeSubprojects, bool includeArchived);
+
+    QStringList reportArguments(const QString &outputFile, const ReportOptions &options) const;
+
 //    Project _activeProject;
     QHash<QString, Project> _cachedProjects;
-    QList<Project> _cachedRecentProjects;
     TomStatus _cachedStatus;
 
     QString _gotimePath;
+    RefreshScheduler *_scheduler;
+    RecentProjects *_recentProjects;
     bool _bashScript;
+    quint64 _dataGeneration;
     QMutex _mutex;
 
     void refreshProjectStatus(bool emitProjectStatusChanged = false);
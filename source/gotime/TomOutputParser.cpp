@@ -0,0 +1,402 @@
+#include <cctype>
+
+#include <QtCore/QDebug>
+#include <QtCore/QFuture>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+
+#include "TomOutputParser.h"
+
+// outputs smaller than this are parsed on the calling thread
+static const int PARALLEL_THRESHOLD = 256 * 1024;
+// chunks should not be smaller than this to keep the overhead low
+static const int MIN_CHUNK_SIZE = 64 * 1024;
+
+namespace {
+    struct FrameChunk {
+        QList<Frame *> frames;
+        // true if an invalid item stopped the parsing
+        bool stopped = false;
+        bool failed = false;
+    };
+
+    FrameChunk parseFrameArray(const QByteArray &json) {
+        FrameChunk chunk;
+
+        QJsonParseError err = QJsonParseError();
+        QJsonDocument doc = QJsonDocument::fromJson(json, &err);
+        if (err.error != QJsonParseError::NoError) {
+            qWarning() << "json parse error" << err.errorString();
+            chunk.failed = true;
+            return chunk;
+        }
+
+        if (!doc.isArray()) {
+            chunk.stopped = true;
+            return chunk;
+        }
+
+        const QJsonArray &items = doc.array();
+        for (const auto &arrayItem: items) {
+            if (!arrayItem.isObject()) {
+                qDebug() << "item not an object" << arrayItem;
+                chunk.stopped = true;
+                break;
+            }
+
+            chunk.frames.append(new Frame(TomOutputParser::parseFrame(arrayItem.toObject())));
+        }
+        return chunk;
+    }
+}
+
+QList<Frame *> TomOutputParser::parseFrames(const QByteArray &json) {
+    const QVector<Range> &ranges = splitJsonArray(json, chunkCount(json.size()));
+    QList<FrameChunk> chunks;
+    if (ranges.size() <= 1) {
+        chunks << parseFrameArray(json);
+    } else {
+        QList<QFuture<FrameChunk>> futures;
+        for (const auto &range : ranges) {
+            futures << QtConcurrent::run([&json, range] {
+                QByteArray chunk;
+                chunk.reserve(range.second - range.first + 2);
+                chunk.append('[').append(json.constData() + range.first, range.second - range.first).append(']');
+                return parseFrameArray(chunk);
+            });
+        }
+
+        for (auto &future : futures) {
+            chunks << future.result();
+        }
+    }
+
+    // merge in the order of the output, the first invalid item ends the result
+    QList<Frame *> result;
+    bool done = false;
+    for (const auto &chunk : chunks) {
+        if (chunk.failed) {
+            for (const auto &c : chunks) {
+                qDeleteAll(c.frames);
+            }
+            return QList<Frame *>();
+        }
+
+        if (done) {
+            qDeleteAll(chunk.frames);
+            continue;
+        }
+
+        result.append(chunk.frames);
+        done = chunk.stopped;
+    }
+    return result;
+}
+
+Frame TomOutputParser::parseFrame(const QJsonObject &item) {
+    const QString id = item["id"].toString();
+    const QString projectID = item["projectID"].toString();
+    const QDateTime start = QDateTime::fromString(item["startTime"].toString(), Qt::ISODate);
+    const QDateTime end = QDateTime::fromString(item["stopTime"].toString(), Qt::ISODate);
+    const QDateTime lastUpdated = QDateTime::fromString(item["lastUpdated"].toString(), Qt::ISODate);
+    const QString notes = item["notes"].toString("");
+    const QStringList tags = QStringList(); // fixme
+    const bool archived = item["archived"].toBool(false);
+
+    return Frame(id, projectID, start, end, lastUpdated, notes, tags, archived);
+}
+
+QList<Project> TomOutputParser::parseProjects(const QString &output) {
+    const QVector<Range> &ranges = splitLines(output, chunkCount(output.size()));
+    if (ranges.size() <= 1) {
+        return parseProjectLines(QStringRef(&output));
+    }
+
+    QList<QFuture<QList<Project>>> futures;
+    for (const auto &range : ranges) {
+        futures << QtConcurrent::run([&output, range] {
+            return parseProjectLines(output.midRef(range.first, range.second - range.first));
+        });
+    }
+
+    QList<Project> result;
+    for (auto &future : futures) {
+        result.append(future.result());
+    }
+    return result;
+}
+
+QHash<QString, ProjectStatus> TomOutputParser::parseProjectsStatus(const QString &output, int expectedColumns) {
+    const QVector<Range> &ranges = splitLines(output, chunkCount(output.size()));
+    if (ranges.size() <= 1) {
+        return parseStatusLines(QStringRef(&output), expectedColumns);
+    }
+
+    QList<QFuture<QHash<QString, ProjectStatus>>> futures;
+    for (const auto &range : ranges) {
+        futures << QtConcurrent::run([&output, range, expectedColumns] {
+            return parseStatusLines(output.midRef(range.first, range.second - range.first), expectedColumns);
+        });
+    }
+
+    QHash<QString, ProjectStatus> result;
+    for (auto &future : futures) {
+        const QHash<QString, ProjectStatus> &chunk = future.result();
+        for (auto it = chunk.constBegin(); it != chunk.constEnd(); ++it) {
+            result.insert(it.key(), it.value());
+        }
+    }
+    return result;
+}
+
+int TomOutputParser::chunkCount(int size) {
+    if (size < PARALLEL_THRESHOLD) {
+        return 1;
+    }
+    return qBound(1, size / MIN_CHUNK_SIZE, QThreadPool::globalInstance()->maxThreadCount());
+}
+
+QVector<TomOutputParser::Range> TomOutputParser::splitJsonArray(const QByteArray &json, int chunkCount) {
+    QVector<Range> ranges;
+    if (chunkCount <= 1) {
+        return ranges;
+    }
+
+    const int size = json.size();
+    const char *data = json.constData();
+
+    int start = 0;
+    while (start < size && isspace(static_cast<unsigned char>(data[start]))) {
+        start++;
+    }
+    if (start == size || data[start] != '[') {
+        return ranges;
+    }
+
+    const int chunkSize = size / chunkCount;
+    int chunkStart = start + 1;
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+
+    for (int i = start + 1; i < size; i++) {
+        const char c = data[i];
+        if (inString) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                inString = false;
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"':
+                inString = true;
+                break;
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (depth == 0) {
+                    // end of the top-level array
+                    ranges << Range(chunkStart, i);
+                    return ranges;
+                }
+                depth--;
+                break;
+            case ',':
+                if (depth == 0 && i - chunkStart >= chunkSize) {
+                    ranges << Range(chunkStart, i);
+                    chunkStart = i + 1;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    // the array wasn't terminated, the sequential parser reports the error
+    return QVector<Range>();
+}
+
+QVector<TomOutputParser::Range> TomOutputParser::splitLines(const QString &output, int chunkCount) {
+    QVector<Range> ranges;
+    if (chunkCount <= 1) {
+        return ranges;
+    }
+
+    const int size = output.size();
+    const int chunkSize = size / chunkCount;
+
+    int chunkStart = 0;
+    while (chunkStart < size) {
+        int end = output.indexOf('\n', qMin(chunkStart + chunkSize, size - 1));
+        end = end < 0 ? size : end + 1;
+
+        ranges << Range(chunkStart, end);
+        chunkStart = end;
+    }
+    return ranges;
+}
+
+QList<Project> TomOutputParser::parseProjectLines(const QStringRef &lines) {
+    QList<Project> result;
+    for (const auto &line : lines.split("\n", QString::SkipEmptyParts)) {
+        QVector<QStringRef> lineItems = line.split("\t");
+        if (lineItems.size() == 6) {
+            const auto &names = lineItems.at(0).toString().split("||");
+            const auto &id = lineItems.at(1).toString();
+            const auto &parent = lineItems.at(2).toString();
+            const auto &hourlyRate = lineItems.at(3).toString();
+            const auto &noteRequired = lineItems.at(4);
+            const auto &noteRequiredInherited = lineItems.at(5);
+
+            TriState noteRequiredValue;
+            if (noteRequired == "true") {
+                noteRequiredValue = TRUE;
+            } else if (noteRequired == "false") {
+                noteRequiredValue = FALSE;
+            } else {
+                noteRequiredValue = UNDEFINED;
+                if (noteRequired != "") {
+                    qWarning() << "invalid value found for noteRequired:" << noteRequired;
+                }
+            }
+
+            const bool noteRequiredInheritedValue = noteRequiredInherited == "true";
+
+            result.append(Project(names, id, parent, hourlyRate, noteRequiredValue, noteRequiredInheritedValue));
+        }
+    }
+    return result;
+}
+
+QHash<QString, ProjectStatus> TomOutputParser::parseStatusLines(const QStringRef &lines, int expectedColumns) {
+    QHash<QString, ProjectStatus> mapping;
+    for (const auto &line : lines.split("\n", QString::SkipEmptyParts)) {
+        QVector<QStringRef> parts = line.split("\t");
+        if (parts.size() != expectedColumns) {
+            qDebug() << "unexpected number of columns in" << line;
+            continue;
+        }
+
+        QString id = parts.takeFirst().toString();
+
+        Timespan day = Timespan(parts.takeFirst().toLongLong());
+        Timespan dayTotal = Timespan(parts.takeFirst().toLongLong());
+
+        Timespan yesterday = Timespan(parts.takeFirst().toLongLong());
+        Timespan yesterdayTotal = Timespan(parts.takeFirst().toLongLong());
+
+        Timespan week = Timespan(parts.takeFirst().toLongLong());
+        Timespan weekTotal = Timespan(parts.takeFirst().toLongLong());
+
+        Timespan month = Timespan(parts.takeFirst().toLongLong());
+        Timespan monthTotal = Timespan(parts.takeFirst().toLongLong());
+
+        Timespan year = Timespan(parts.takeFirst().toLongLong());
+        Timespan yearTotal = Timespan(parts.takeFirst().toLongLong());
+
+        Timespan all = Timespan(parts.takeFirst().toLongLong());
+        Timespan allTotal = Timespan(parts.takeFirst().toLongLong());
+
+        mapping.insert(id, ProjectStatus(id, all, allTotal,
+                                         year, yearTotal,
+                                         month, monthTotal,
+                                         week, weekTotal,
+                                         yesterday, yesterdayTotal,
+                                         day, dayTotal));
+    }
+    return mapping;
+}
+
+FrameStreamParser::FrameStreamParser() : _depth(0),
+                                         _inString(false),
+                                         _escaped(false),
+                                         _finished(false),
+                                         _failed(false) {
+}
+
+bool FrameStreamParser::feed(const QByteArray &data, const Callback &callback) {
+    if (_failed) {
+        return false;
+    }
+
+    const char *bytes = data.constData();
+    const int size = data.size();
+    // the start of the current element in this chunk
+    int elementStart = _depth >= 2 ? 0 : -1;
+
+    for (int i = 0; i < size && !_finished; i++) {
+        const char c = bytes[i];
+        if (_depth >= 2 && _inString) {
+            if (_escaped) {
+                _escaped = false;
+            } else if (c == '\\') {
+                _escaped = true;
+            } else if (c == '"') {
+                _inString = false;
+            }
+            continue;
+        }
+
+        if (_depth == 0) {
+            if (c == '[') {
+                _depth = 1;
+            } else if (!isspace(static_cast<unsigned char>(c))) {
+                _failed = true;
+                return false;
+            }
+        } else if (_depth == 1) {
+            if (c == '{') {
+                _depth = 2;
+                elementStart = i;
+            } else if (c == ']') {
+                _finished = true;
+            } else if (c != ',' && !isspace(static_cast<unsigned char>(c))) {
+                _failed = true;
+                return false;
+            }
+        } else if (c == '"') {
+            _inString = true;
+        } else if (c == '{' || c == '[') {
+            _depth++;
+        } else if (c == '}' || c == ']') {
+            if (--_depth == 1) {
+                // the element is complete
+                _element.append(bytes + elementStart, i - elementStart + 1);
+                const QJsonDocument &doc = QJsonDocument::fromJson(_element);
+                _element.clear();
+                elementStart = -1;
+
+                if (!doc.isObject()) {
+                    _failed = true;
+                    return false;
+                }
+
+                Frame frame = TomOutputParser::parseFrame(doc.object());
+                if (!callback(frame)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // keep the beginning of an element which continues in the next chunk
+    if (_depth >= 2 && elementStart >= 0) {
+        _element.append(bytes + elementStart, size - elementStart);
+    }
+    return true;
+}
+
+bool FrameStreamParser::isFinished() const {
+    return _finished;
+}
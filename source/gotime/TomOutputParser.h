@@ -0,0 +1,82 @@
+#ifndef TOM_UI_TOMOUTPUTPARSER_H
+#define TOM_UI_TOMOUTPUTPARSER_H
+
+#include <functional>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "data/Frame.h"
+#include "data/Project.h"
+#include "ProjectStatus.h"
+
+/**
+ * Parses the output of tom's frames, projects and status commands.
+ * Large outputs are split at record boundaries and the chunks are parsed in parallel
+ * on the global thread pool. The results are merged in the order of the output.
+ */
+class TomOutputParser {
+public:
+    static QList<Frame *> parseFrames(const QByteArray &json);
+
+    static QList<Project> parseProjects(const QString &output);
+
+    static QHash<QString, ProjectStatus> parseProjectsStatus(const QString &output, int expectedColumns);
+
+    static Frame parseFrame(const QJsonObject &item);
+
+private:
+    typedef QPair<int, int> Range;
+
+    /**
+     * Splits a JSON array into ranges of complete elements, the brackets of the array are not part of the ranges.
+     * Returns an empty list if the data is not a JSON array.
+     */
+    static QVector<Range> splitJsonArray(const QByteArray &json, int chunkCount);
+
+    static QVector<Range> splitLines(const QString &output, int chunkCount);
+
+    static int chunkCount(int size);
+
+    static QList<Project> parseProjectLines(const QStringRef &lines);
+
+    static QHash<QString, ProjectStatus> parseStatusLines(const QStringRef &lines, int expectedColumns);
+};
+
+/**
+ * Parses the JSON array of tom's frames command while it's read.
+ * Only the element which is currently read is kept in memory, each complete frame is passed to the callback.
+ */
+class FrameStreamParser {
+public:
+    typedef std::function<bool(Frame &)> Callback;
+
+    FrameStreamParser();
+
+    /**
+     * Parses the next chunk of the output.
+     * @return false if the data is invalid or if the callback returned false.
+     */
+    bool feed(const QByteArray &data, const Callback &callback);
+
+    /**
+     * @return true if the end of the array was read.
+     */
+    bool isFinished() const;
+
+private:
+    // the beginning of the current element, if it started in a previous chunk
+    QByteArray _element;
+    // 0 before the array, 1 between the elements, more inside of an element
+    int _depth;
+    bool _inString;
+    bool _escaped;
+    bool _finished;
+    bool _failed;
+};
+
+#endif //TOM_UI_TOMOUTPUTPARSER_H
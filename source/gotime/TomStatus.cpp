@@ -26,3 +26,18 @@ const QDateTime &TomStatus::startTime() const {
 const QString &TomStatus::timeEntryId() const {
     return _timeEntryId;
 }
+
+QDataStream &operator<<(QDataStream &out, const TomStatus &status) {
+    return out << status.isValid << status.timeEntryId() << status.currentProject() << status.startTime();
+}
+
+QDataStream &operator>>(QDataStream &in, TomStatus &status) {
+    bool valid = false;
+    QString timeEntryID;
+    Project project;
+    QDateTime startTime;
+    in >> valid >> timeEntryID >> project >> startTime;
+
+    status = TomStatus(valid, timeEntryID, project, startTime);
+    return in;
+}
@@ -1,6 +1,7 @@
 #ifndef GOTIME_UI_GOTIMESTATUS_H
 #define GOTIME_UI_GOTIMESTATUS_H
 
+#include <QtCore/QDataStream>
 #include <QtCore/QDateTime>
 #include "data/Project.h"
 
@@ -28,4 +29,8 @@ inline bool operator==(const TomStatus &a, const TomStatus &b) { return a.curren
 
 inline bool operator!=(const TomStatus &a, const TomStatus &b) { return !operator==(a, b); }
 
+QDataStream &operator<<(QDataStream &out, const TomStatus &status);
+
+QDataStream &operator>>(QDataStream &in, TomStatus &status);
+
 #endif 
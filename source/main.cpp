@@ -1,4 +1,5 @@
 #include <QApplication>
+#include <QtCore/QTextStream>
 #include <QtWidgets/QMessageBox>
 
 #include "qxt/qxtglobalshortcut.h"
@@ -6,12 +7,76 @@
 #include "projectlookup/projectlookup.h"
 #include "settings/TomSettings.h"
 #include "gotime/ProjectStatusManager.h"
+#include "gotime/StartupOrchestrator.h"
+#include "gotime/StartupSnapshot.h"
 #include "main_window.h"
 #include "tray.h"
 #include "version.h"
 #include "GlobalShortcuts.h"
+#include "report/FrameExporter.h"
+
+// exports the time entries without the user interface, returns the exit code
+static int exportFrames(TomControl *control, const QCommandLineParser &parser) {
+    QTextStream err(stderr);
+
+    FrameExporter::Options options;
+    options.projectID = parser.value("export-project");
+    options.includeArchived = !parser.isSet("export-skip-archived");
+
+    const QString &target = parser.value("export");
+    const QString &format = parser.value("export-format");
+    if (format.isEmpty()) {
+        options.format = FrameExporter::formatForFile(target);
+    } else if (format == "csv") {
+        options.format = FrameExporter::CSV;
+    } else if (format == "jsonl") {
+        options.format = FrameExporter::JSONLines;
+    } else {
+        err << QCoreApplication::translate("main", "Unknown export format: %1").arg(format) << endl;
+        return 1;
+    }
+
+    const QString &from = parser.value("export-from");
+    const QString &to = parser.value("export-to");
+    options.start = QDate::fromString(from, Qt::ISODate);
+    options.end = QDate::fromString(to, Qt::ISODate);
+    if ((!from.isEmpty() && !options.start.isValid()) || (!to.isEmpty() && !options.end.isValid())) {
+        err << QCoreApplication::translate("main", "Invalid date, the format is YYYY-MM-DD") << endl;
+        return 1;
+    }
+
+    QFile file;
+    bool opened;
+    if (target == "-") {
+        opened = file.open(stdout, QIODevice::WriteOnly);
+    } else {
+        file.setFileName(target);
+        opened = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!opened) {
+        err << QCoreApplication::translate("main", "Unable to write %1: %2").arg(target, file.errorString()) << endl;
+        return 1;
+    }
+
+    FrameExporter exporter(control, options);
+    if (!exporter.exportTo(&file)) {
+        err << QCoreApplication::translate("main", "The export failed.") << endl;
+        return 1;
+    }
+    return 0;
+}
+
+static void showConfigurationError(const QString &command) {
+    const QString &message = QCoreApplication::translate("main",
+                                                         "The tom command line application was not found or is not working as expected."
+                                                         "<br>Path: <i>%1</i><br>Terminating.").arg(command);
+    QMessageBox::critical(nullptr, QCoreApplication::translate("main", "Configuration error"), message);
+}
 
 int main(int argc, char *argv[]) {
+    QElapsedTimer startupClock;
+    startupClock.start();
+
 #ifdef Q_OS_MAC
     QApplication::setAttribute(Qt::AA_DontShowIconsInMenus);
 #endif
@@ -49,7 +114,21 @@ int main(int argc, char *argv[]) {
                               {"bash",       QCoreApplication::translate("main",
                                                                          "Defines if the tom executable is to be treated as a Bash file")},
                               {"configName", QCoreApplication::translate("main",
-                                                                         "Defines the configuration name, useful to test Tom"), "configName", "Tom"}
+                                                                         "Defines the configuration name, useful to test Tom"), "configName", "Tom"},
+                              {"export",     QCoreApplication::translate("main",
+                                                                         "Exports the time entries to the file and quits, - writes to stdout"), "file"},
+                              {"export-format", QCoreApplication::translate("main",
+                                                                         "Format of the export, csv or jsonl. Defaults to the extension of the file"), "format"},
+                              {"export-project", QCoreApplication::translate("main",
+                                                                         "ID of the project to export with its subprojects. Defaults to all projects"), "projectID"},
+                              {"export-from", QCoreApplication::translate("main",
+                                                                         "First day of the exported time entries, YYYY-MM-DD"), "date"},
+                              {"export-to",  QCoreApplication::translate("main",
+                                                                         "Last day of the exported time entries, YYYY-MM-DD"), "date"},
+                              {"export-skip-archived", QCoreApplication::translate("main",
+                                                                         "Doesn't export archived time entries")},
+                              {"startup-trace", QCoreApplication::translate("main",
+                                                                         "Prints the timeline of the startup and the refresh wakeups per minute to stderr")}
                       });
 
     // Process the actual command line arguments given by the user
@@ -70,27 +149,59 @@ int main(int argc, char *argv[]) {
     myappTranslator.load(":/translations/tom_" + QLocale::system().name());
     QApplication::installTranslator(&myappTranslator);
 
+    // all commands needed at startup run concurrently
+    StartupOrchestrator startup(startupClock, parser.isSet("startup-trace"));
+    startup.mark("application created");
+
     auto *control = new TomControl(command, bash, &app);
-    const CommandStatus &status = control->version();
-    if (status.isFailed()) {
-        const QString &message = QCoreApplication::translate("main",
-                                                             "The tom command line application was not found or is not working as expected."
-                                                             "<br>Path: <i>%1</i><br>Terminating.").arg(command);
-        QMessageBox::critical(nullptr, QCoreApplication::translate("main", "Configuration error"), message);
-        QApplication::exit(-1);
-        return -1;
+    const bool exporting = parser.isSet("export");
+    startup.start(control, !exporting);
+
+    // with a snapshot of the last session the window is displayed without waiting for tom
+    StartupSnapshot snapshot(configName, command);
+    const bool warmStart = !exporting && snapshot.read();
+    if (warmStart) {
+        control->setStartupData(snapshot.projects, snapshot.status);
+        startup.mark("snapshot loaded");
+
+        QObject::connect(&startup, &StartupOrchestrator::tomFailed, [command] {
+            showConfigurationError(command);
+            QApplication::exit(-1);
+        });
+        startup.revalidate();
+    } else {
+        const CommandStatus &status = startup.waitForVersion();
+        if (status.isFailed()) {
+            showConfigurationError(command);
+            QApplication::exit(-1);
+            return -1;
+        }
+
+        startup.waitForProjects();
+        if (exporting) {
+            return exportFrames(control, parser);
+        }
     }
 
     auto config = new TomSettings(&app);
+    control->recentProjects()->setMaxCount(config->recentProjectsCount());
+    QObject::connect(config, &TomSettings::recentProjectsCountChanged, control->recentProjects(), &RecentProjects::setMaxCount);
     auto *statusManager = new ProjectStatusManager(control, &app);
+    if (warmStart) {
+        statusManager->setSnapshotStatus(snapshot.projectsStatus);
+    }
+    startup.loadFramesInto(statusManager);
 
     auto *globalShortcuts = new GlobalShortcuts(control, nullptr);
 
-    MainWindow mainWindow(control, statusManager, config, globalShortcuts);
+    MainWindow mainWindow(control, statusManager, config, globalShortcuts, &snapshot);
+    QObject::connect(&startup, &StartupOrchestrator::projectsChanged, &mainWindow, &MainWindow::reloadCachedProjects);
     globalShortcuts->setupShortcuts(&mainWindow);
+    startup.mark("main window created");
 
     if (config->openMainWindowAtStartup()) {
         mainWindow.show();
+        startup.mark("main window shown");
     }
 
     new GotimeTrayIcon(control, &mainWindow);
@@ -5,6 +5,8 @@
 #include <dialogs/CommonDialogs.h>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QInputDialog>
+#include <QtWidgets/QProgressDialog>
+#include <QtConcurrent/QtConcurrent>
 #include <source/frameEditor/FrameEditorDialog.h>
 
 #include "settingsDialog/SettingsDialog.h"
@@ -14,12 +16,14 @@
 #include "ActionUtils.h"
 #include "projectEditor/ProjectEditorDialog.h"
 #include "report/ProjectReportDialog.h"
+#include "report/FrameExporter.h"
 #include "projectlookup/projectlookup.h"
 
 MainWindow::MainWindow(TomControl *control,
                        ProjectStatusManager *statusManager,
                        TomSettings *settings,
                        GlobalShortcuts *globalShortcuts,
+                       StartupSnapshot *snapshot,
                        QWidget *parent)
         : QMainWindow(parent),
           Ui::MainWindow(),
@@ -27,7 +31,11 @@ MainWindow::MainWindow(TomControl *control,
           _statusManager(statusManager),
           _settings(settings),
           _globalShortcuts(globalShortcuts),
-          _frameStatusLabel(new QLabel(this)) {
+          _snapshot(snapshot),
+          _frameStatusLabel(new QLabel(this)),
+          _frameSelection(nullptr),
+          _frameGroupSelection(nullptr),
+          _reportCache(new ReportCache(control, true, this)) {
 
 //#ifndef Q_OS_MAC
     setWindowIcon(Icons::LogoLarge());
@@ -40,7 +48,9 @@ MainWindow::MainWindow(TomControl *control,
 #endif
 
     _projectTree->setup(control, statusManager);
+    connect(_projectFilter, &QLineEdit::textChanged, _projectTree, &ProjectTreeView::setFilterText);
     _frameView->setup(control, statusManager);
+    _frameGroupView->setup(control, statusManager, _frameView->frameModel());
 
     // setup the statusbar
     mainStatusBar->addPermanentWidget(_frameStatusLabel, 1);
@@ -48,8 +58,16 @@ MainWindow::MainWindow(TomControl *control,
 
     connect(_projectTree->selectionModel(), &QItemSelectionModel::currentChanged, this, &MainWindow::updateStatusBar);
     connect(_projectTree->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::updateStatusBar);
-    connect(_frameView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::updateStatusBar);
-    connect(_frameView->selectionModel(), &QItemSelectionModel::currentChanged, this, &MainWindow::updateStatusBar);
+
+    // the totals of the selected time entries are updated with the selection deltas
+    _frameSelection = new FrameSelectionAggregate(control, _frameView->selectionModel(), [this](const QModelIndex &index) {
+        return _frameView->frameAt(index);
+    }, this);
+    _frameGroupSelection = new FrameSelectionAggregate(control, _frameGroupView->selectionModel(), [this](const QModelIndex &index) {
+        return _frameGroupView->frameAt(index);
+    }, this);
+    connect(_frameSelection, &FrameSelectionAggregate::changed, this, &MainWindow::updateStatusBar);
+    connect(_frameGroupSelection, &FrameSelectionAggregate::changed, this, &MainWindow::updateStatusBar);
 
     // fix icons
     actionRefresh->setIcon(Icons::refreshData());
@@ -99,12 +117,31 @@ MainWindow::MainWindow(TomControl *control,
     connect(actionSettingsShowArchived, &QAction::toggled, _statusManager, &ProjectStatusManager::setIncludeArchived);
 
     connect(actionTimeEntryLastUpdatedColumn, &QAction::toggled, _frameView, &FrameTableView::setShowLastUpdatedColumn);
+    connect(actionSettingsShowArchived, &QAction::toggled, _frameGroupView, &FrameGroupView::setShowArchived);
+    connect(actionTimeEntryLastUpdatedColumn, &QAction::toggled, _frameGroupView, &FrameGroupView::setShowLastUpdatedColumn);
+
+    // grouping by day and by week are exclusive, but both may be turned off
+    connect(actionTimeEntriesGroupByDay, &QAction::toggled, [this](bool checked) {
+        if (checked) {
+            actionTimeEntriesGroupByWeek->setChecked(false);
+        }
+        onFrameGroupingChange();
+    });
+    connect(actionTimeEntriesGroupByWeek, &QAction::toggled, [this](bool checked) {
+        if (checked) {
+            actionTimeEntriesGroupByDay->setChecked(false);
+        }
+        onFrameGroupingChange();
+    });
 
     connect(_control, &TomControl::projectStatusChanged, this, &MainWindow::onProjectStatusChange);
 
     connect(actionQuit, &QAction::triggered, &QCoreApplication::quit);
 
     connect(QGuiApplication::instance(), &QCoreApplication::aboutToQuit, this, &MainWindow::writeSettings);
+    connect(QGuiApplication::instance(), &QCoreApplication::aboutToQuit, this, &MainWindow::saveSnapshot);
+    // the snapshot is saved periodically, too, because the application may not quit normally
+    _control->scheduler()->addTask("startup snapshot", 5 * 60 * 1000, RefreshScheduler::BackgroundTask, this, [this] { saveSnapshot(); });
 
     // listen to focus events
     connect(dynamic_cast<QApplication *>(QCoreApplication::instance()), &QApplication::focusChanged,
@@ -118,7 +155,16 @@ MainWindow::MainWindow(TomControl *control,
     menuProject->addAction(_projectTree->getDeleteAction());
     menuEntries->addAction(_frameView->getDeleteAction());
 
-    refreshData();
+    // the data was loaded at startup, only the state of the actions is updated
+    _projectTree->expandToDepth(0);
+    onProjectStatusChange();
+    onProjectSelectionChange(Project());
+    onEntrySelectionChange(QItemSelection());
+
+    // the frames of the snapshot are displayed when readSettings() restores the selected project
+    if (_snapshot->hasSelectedFrames) {
+        _frameView->frameModel()->preloadFrames(_snapshot->selectedProjectID, _snapshot->selectedFramesArchived, _snapshot->selectedFrames);
+    }
 
     readSettings();
 }
@@ -128,6 +174,28 @@ void MainWindow::closeEvent(QCloseEvent *event) {
     QMainWindow::closeEvent(event);
 }
 
+void MainWindow::showEvent(QShowEvent *event) {
+    QMainWindow::showEvent(event);
+    updateViewsVisible();
+}
+
+void MainWindow::hideEvent(QHideEvent *event) {
+    QMainWindow::hideEvent(event);
+    updateViewsVisible();
+}
+
+void MainWindow::changeEvent(QEvent *event) {
+    QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange) {
+        updateViewsVisible();
+    }
+}
+
+void MainWindow::updateViewsVisible() {
+    // the views don't need to be refreshed while the window is in the tray or minimized
+    _control->scheduler()->setViewsVisible(isVisible() && !isMinimized());
+}
+
 void MainWindow::writeSettings() {
     _projectTree->writeSettings();
     _frameView->writeSettings();
@@ -165,6 +233,30 @@ void MainWindow::readSettings() {
     }
 }
 
+void MainWindow::saveSnapshot() {
+    _snapshot->projects = _control->cachedProjects();
+    _snapshot->status = _control->cachedStatus();
+    _snapshot->projectsStatus = _statusManager->currentStatus();
+
+    const FrameTableViewModel *frames = _frameView->frameModel();
+    _snapshot->hasSelectedFrames = frames->currentProject().isValidOrRootProject();
+    _snapshot->selectedProjectID = frames->currentProject().getID();
+    _snapshot->selectedFramesArchived = frames->isShowingArchived();
+    _snapshot->selectedFrames = _snapshot->hasSelectedFrames ? frames->currentFrames() : QList<Frame>();
+
+    _snapshot->write();
+}
+
+void MainWindow::reloadCachedProjects() {
+    const Project &selected = _projectTree->getCurrentProject();
+
+    _projectTree->refresh();
+    if (selected.isValid()) {
+        _projectTree->selectProject(_control->cachedProject(selected.getID()));
+    }
+    onProjectStatusChange();
+}
+
 void MainWindow::refreshData() {
     _control->resetCache();
 
@@ -224,6 +316,55 @@ void MainWindow::importWatson() {
     }
 }
 
+void MainWindow::exportTimeEntries() {
+    QString selectedFilter;
+    const QString &fileName = QFileDialog::getSaveFileName(this,
+                                                           tr("Export time entries"),
+                                                           "",
+                                                           tr("CSV files (*.csv);;JSON Lines files (*.jsonl)"),
+                                                           &selectedFilter);
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    // without a selected project the entries of all projects are exported
+    FrameExporter::Options options;
+    options.projectID = _projectTree->getCurrentProject().getID();
+    options.format = selectedFilter.contains("*.jsonl") ? FrameExporter::JSONLines : FrameExporter::formatForFile(fileName);
+    FrameExporter exporter(_control, options);
+
+    QPointer<QProgressDialog> progressDialog = new QProgressDialog(tr("Exporting time entries..."), tr("Cancel"), 0, 0, this);
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(500);
+    progressDialog->setAttribute(Qt::WA_DeleteOnClose);
+
+    auto cancelled = QSharedPointer<QAtomicInt>::create(0);
+    connect(progressDialog, &QProgressDialog::canceled, [cancelled] {
+        cancelled->storeRelease(1);
+    });
+
+    auto *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, progressDialog, cancelled, fileName] {
+        if (progressDialog) {
+            progressDialog->close();
+        }
+        if (!watcher->result() && !cancelled->loadAcquire()) {
+            QMessageBox::warning(this, tr("Export failed"), tr("The time entries couldn't be exported to %1.").arg(fileName));
+        }
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::run([exporter, fileName, cancelled]() mutable {
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            return false;
+        }
+        return exporter.exportTo(&file, [cancelled](qint64) {
+            return cancelled->loadAcquire() == 0;
+        });
+    }));
+}
+
 void MainWindow::resetAllData() {
     QMessageBox::StandardButton reply = QMessageBox::question(this,
                                                               tr("Reset data"),
@@ -320,10 +461,10 @@ void MainWindow::editCurrentProject() {
 }
 
 void MainWindow::editCurrentTimeEntry() {
-    QList<Frame *> frames = _frameView->selectedFrames();
+    QList<Frame *> frames = selectedTimeEntries();
     if (frames.size() == 1) {
         Frame *frame = frames[0];
-        FrameEditorDialog::show(*frame, _control, _statusManager, this);
+        FrameEditorDialog::show(*frame, _control, _statusManager, &_frameView->frameModel()->intervalIndex(), this);
     }
 }
 
@@ -340,7 +481,7 @@ void MainWindow::createReport() {
         selected << project;
     }
 
-    auto *dialog = new ProjectReportDialog(selected, _control, _statusManager, this);
+    auto *dialog = new ProjectReportDialog(selected, _control, _statusManager, _reportCache, this);
     dialog->exec();
 }
 
@@ -353,7 +494,7 @@ void MainWindow::focusProjectTree() {
 }
 
 void MainWindow::focusEntriesList() {
-    _frameView->setFocus();
+    _frameStack->currentWidget()->setFocus();
 }
 
 void MainWindow::focusChanged(QWidget *, QWidget *now) {
@@ -387,14 +528,20 @@ void MainWindow::focusChanged(QWidget *, QWidget *now) {
 }
 
 void MainWindow::updateStatusBar() {
-    auto selected = _frameView->selectedFrames();
-    if (selected.size() > 1) {
-        qlonglong millis = 0;
-        for (auto f : selected) {
-            millis += f->durationMillis(true);
+    const FrameSelectionAggregate *selection = selectionAggregate();
+    if (selection->count() > 1) {
+        Timespan span(selection->totalMillis());
+        QString text = tr("%n entries, total: %1 / %2, min: %3, max: %4", "statusbar", selection->count())
+                .arg(span.format())
+                .arg(span.formatDecimal())
+                .arg(Timespan(selection->minMillis()).format())
+                .arg(Timespan(selection->maxMillis()).format());
+
+        double earnings = selection->earnings();
+        if (earnings > 0) {
+            text += tr(", earnings: %1", "statusbar").arg(QLocale().toString(earnings, 'f', 2));
         }
-        Timespan span(millis);
-        _frameStatusLabel->setText(tr("Total: %1 / %2", "statusbar").arg(span.format()).arg(span.formatDecimal()));
+        _frameStatusLabel->setText(text);
     } else {
         _frameStatusLabel->setText("");
     }
@@ -408,3 +555,30 @@ void MainWindow::openApplicationSettings() {
     auto *dialog = new SettingsDialog(this, _globalShortcuts, _settings, additionalActions);
     dialog->open();
 }
+
+void MainWindow::onFrameGroupingChange() {
+    if (actionTimeEntriesGroupByDay->isChecked()) {
+        _frameGroupView->setGrouping(FrameGroupModel::GroupByDay);
+        _frameStack->setCurrentWidget(_frameGroupView);
+    } else if (actionTimeEntriesGroupByWeek->isChecked()) {
+        _frameGroupView->setGrouping(FrameGroupModel::GroupByWeek);
+        _frameStack->setCurrentWidget(_frameGroupView);
+    } else {
+        _frameStack->setCurrentWidget(_frameView);
+    }
+    updateStatusBar();
+}
+
+const FrameSelectionAggregate *MainWindow::selectionAggregate() const {
+    if (_frameStack->currentWidget() == _frameGroupView) {
+        return _frameGroupSelection;
+    }
+    return _frameSelection;
+}
+
+QList<Frame *> MainWindow::selectedTimeEntries() const {
+    if (_frameStack->currentWidget() == _frameGroupView) {
+        return _frameGroupView->selectedFrames();
+    }
+    return _frameView->selectedFrames();
+}
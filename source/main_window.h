@@ -11,13 +11,16 @@
 #include "settings/TomSettings.h"
 #include "gotime/TomControl.h"
 #include "gotime/ProjectStatusManager.h"
+#include "gotime/StartupSnapshot.h"
+#include "model/FrameSelectionAggregate.h"
+#include "report/ReportCache.h"
 
 class MainWindow : public QMainWindow, private Ui::MainWindow {
 Q_OBJECT
 
 public:
     explicit MainWindow(TomControl *control, ProjectStatusManager *statusManager, TomSettings *settings,
-                        GlobalShortcuts *globalShortcuts, QWidget *parent = nullptr);
+                        GlobalShortcuts *globalShortcuts, StartupSnapshot *snapshot, QWidget *parent = nullptr);
 
     ~MainWindow() override;
 
@@ -31,6 +34,11 @@ public slots:
 
     void stopCurrentProject(bool restart = false);
 
+    /**
+     * Displays the cached projects of the control, e.g. when they replaced the projects of the startup snapshot.
+     */
+    void reloadCachedProjects();
+
 private slots:
 
     void refreshData();
@@ -43,6 +51,8 @@ private slots:
 
     void importWatson();
 
+    void exportTimeEntries();
+
     void startCurrentProject();
 
     void deleteCurrentProject();
@@ -73,23 +83,43 @@ private slots:
 
     void updateStatusBar();
 
+    void onFrameGroupingChange();
+
     void openApplicationSettings();
 
 protected:
     void closeEvent(QCloseEvent *event) override;
 
+    void showEvent(QShowEvent *event) override;
+
+    void hideEvent(QHideEvent *event) override;
+
+    void changeEvent(QEvent *event) override;
+
 private slots:
 
     void writeSettings();
 
+    void saveSnapshot();
+
 private:
     TomControl *_control;
     ProjectStatusManager *_statusManager;
     TomSettings *_settings;
     GlobalShortcuts *_globalShortcuts;
+    StartupSnapshot *_snapshot;
     QLabel *_frameStatusLabel;
+    FrameSelectionAggregate *_frameSelection;
+    FrameSelectionAggregate *_frameGroupSelection;
+    ReportCache *_reportCache;
 
     void readSettings();
+
+    void updateViewsVisible();
+
+    QList<Frame *> selectedTimeEntries() const;
+
+    const FrameSelectionAggregate *selectionAggregate() const;
 };
 
 #endif
@@ -0,0 +1,482 @@
+#include <algorithm>
+
+#include <QtGui/QColor>
+#include <QtGui/QFont>
+
+#include "fonts.h"
+#include "FrameGroupModel.h"
+#include "UserRoles.h"
+
+FrameGroupModel::FrameGroupModel(FrameTableViewModel *sourceModel, QObject *parent) : QAbstractProxyModel(parent),
+                                                                                      _frameModel(sourceModel),
+                                                                                      _grouping(GroupByDay),
+                                                                                      _sourceRowsValid(false) {
+    setSourceModel(sourceModel);
+
+    connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, &FrameGroupModel::onSourceAboutToBeReset);
+    connect(sourceModel, &QAbstractItemModel::modelReset, this, &FrameGroupModel::onSourceReset);
+    connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &FrameGroupModel::onSourceRowsAboutToBeRemoved);
+    connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, [this] { _sourceRowsValid = false; });
+    connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &FrameGroupModel::onSourceRowsInserted);
+    connect(sourceModel, &QAbstractItemModel::dataChanged, this, &FrameGroupModel::onSourceDataChanged);
+
+    rebuild();
+}
+
+FrameGroupModel::~FrameGroupModel() {
+    qDeleteAll(_groups);
+}
+
+FrameGroupModel::Grouping FrameGroupModel::grouping() const {
+    return _grouping;
+}
+
+void FrameGroupModel::setGrouping(FrameGroupModel::Grouping grouping) {
+    if (grouping == _grouping) {
+        return;
+    }
+
+    beginResetModel();
+    _grouping = grouping;
+    rebuild();
+    endResetModel();
+}
+
+qint64 FrameGroupModel::Group::totalMillis() const {
+    qint64 total = stoppedMillis;
+    for (auto *frame : activeFrames) {
+        total += frame->durationMillis(true);
+    }
+    return total;
+}
+
+FrameGroupModel::Contribution FrameGroupModel::contributionOf(Frame *frame) const {
+    Contribution c;
+    c.key = groupKey(frame->startTime);
+    c.startMillis = frame->startTime.toMSecsSinceEpoch();
+    c.active = frame->isActive();
+    c.stoppedMillis = c.active ? 0 : frame->durationMillis(false);
+    return c;
+}
+
+QDate FrameGroupModel::groupKey(const QDateTime &start) const {
+    const QDate &day = start.date();
+    if (_grouping == GroupByWeek && day.isValid()) {
+        return day.addDays(1 - day.dayOfWeek());
+    }
+    return day;
+}
+
+QString FrameGroupModel::groupLabel(const Group *group) const {
+    if (_grouping == GroupByWeek) {
+        int year = 0;
+        int week = group->key.weekNumber(&year);
+        return tr("Week %1, %2").arg(week).arg(year);
+    }
+    return group->key.toString(Qt::SystemLocaleLongDate);
+}
+
+int FrameGroupModel::groupRow(const QDate &key) const {
+    auto it = std::lower_bound(_groups.constBegin(), _groups.constEnd(), key, [](const Group *group, const QDate &value) {
+        return group->key > value;
+    });
+    return static_cast<int>(it - _groups.constBegin());
+}
+
+int FrameGroupModel::groupRow(const Group *group) const {
+    return groupRow(group->key);
+}
+
+int FrameGroupModel::entryRow(const Group *group, const Frame *frame, qint64 startMillis) {
+    const auto &entries = group->entries;
+    auto it = std::lower_bound(entries.constBegin(), entries.constEnd(), startMillis, [](const Entry &entry, qint64 value) {
+        return entry.startMillis > value;
+    });
+
+    for (; it != entries.constEnd() && it->startMillis == startMillis; ++it) {
+        if (it->frame == frame) {
+            return static_cast<int>(it - entries.constBegin());
+        }
+    }
+    return -1;
+}
+
+void FrameGroupModel::addFrame(Frame *frame, bool notify) {
+    const Contribution &c = contributionOf(frame);
+
+    int row = groupRow(c.key);
+    Group *group = row < _groups.size() && _groups.at(row)->key == c.key ? _groups.at(row) : nullptr;
+    if (!group) {
+        if (notify) {
+            beginInsertRows(QModelIndex(), row, row);
+        }
+        group = new Group();
+        group->key = c.key;
+        _groups.insert(row, group);
+        if (notify) {
+            endInsertRows();
+        }
+    }
+
+    auto &entries = group->entries;
+    auto it = std::upper_bound(entries.begin(), entries.end(), c.startMillis, [](qint64 value, const Entry &entry) {
+        return value > entry.startMillis;
+    });
+    int entryIndex = static_cast<int>(it - entries.begin());
+
+    if (notify) {
+        beginInsertRows(index(row, 0, QModelIndex()), entryIndex, entryIndex);
+    }
+    entries.insert(entryIndex, Entry{c.startMillis, frame});
+    group->stoppedMillis += c.stoppedMillis;
+    if (c.active) {
+        group->activeFrames << frame;
+    }
+    _contributions.insert(frame, c);
+    if (notify) {
+        endInsertRows();
+        emit dataChanged(index(row, FrameTableViewModel::FIRST_COL, QModelIndex()), index(row, FrameTableViewModel::LAST_COL, QModelIndex()));
+    }
+}
+
+void FrameGroupModel::removeFrame(Frame *frame, bool notify) {
+    auto it = _contributions.find(frame);
+    if (it == _contributions.end()) {
+        return;
+    }
+
+    const Contribution c = it.value();
+    _contributions.erase(it);
+
+    int row = groupRow(c.key);
+    if (row >= _groups.size() || _groups.at(row)->key != c.key) {
+        qWarning() << "frame group not found" << c.key;
+        return;
+    }
+
+    Group *group = _groups.at(row);
+    int entryIndex = entryRow(group, frame, c.startMillis);
+    if (entryIndex < 0) {
+        qWarning() << "frame not found in group" << frame->id;
+        return;
+    }
+
+    if (notify) {
+        beginRemoveRows(index(row, 0, QModelIndex()), entryIndex, entryIndex);
+    }
+    group->entries.remove(entryIndex);
+    group->stoppedMillis -= c.stoppedMillis;
+    if (c.active) {
+        group->activeFrames.removeOne(frame);
+    }
+    if (notify) {
+        endRemoveRows();
+    }
+
+    if (group->entries.isEmpty()) {
+        if (notify) {
+            beginRemoveRows(QModelIndex(), row, row);
+        }
+        _groups.remove(row);
+        delete group;
+        if (notify) {
+            endRemoveRows();
+        }
+    } else if (notify) {
+        emit dataChanged(index(row, FrameTableViewModel::FIRST_COL, QModelIndex()), index(row, FrameTableViewModel::LAST_COL, QModelIndex()));
+    }
+}
+
+void FrameGroupModel::rebuild() {
+    qDeleteAll(_groups);
+    _groups.clear();
+    _contributions.clear();
+    _sourceRowsValid = false;
+
+    const int rows = sourceModel()->rowCount(QModelIndex());
+    _contributions.reserve(rows);
+
+    QHash<QDate, Group *> groups;
+    for (int i = 0; i < rows; i++) {
+        Frame *frame = _frameModel->frameAt(_frameModel->index(i, 0));
+        const Contribution &c = contributionOf(frame);
+
+        Group *&group = groups[c.key];
+        if (!group) {
+            group = new Group();
+            group->key = c.key;
+        }
+
+        group->entries.append(Entry{c.startMillis, frame});
+        group->stoppedMillis += c.stoppedMillis;
+        if (c.active) {
+            group->activeFrames << frame;
+        }
+        _contributions.insert(frame, c);
+    }
+
+    _groups.reserve(groups.size());
+    for (auto *group : groups) {
+        std::stable_sort(group->entries.begin(), group->entries.end(), [](const Entry &a, const Entry &b) {
+            return a.startMillis > b.startMillis;
+        });
+        _groups.append(group);
+    }
+    std::sort(_groups.begin(), _groups.end(), [](const Group *a, const Group *b) {
+        return a->key > b->key;
+    });
+}
+
+int FrameGroupModel::sourceRow(const Frame *frame) const {
+    if (!_sourceRowsValid) {
+        _sourceRows.clear();
+
+        const int rows = sourceModel()->rowCount(QModelIndex());
+        _sourceRows.reserve(rows);
+        for (int i = 0; i < rows; i++) {
+            _sourceRows.insert(_frameModel->frameAt(_frameModel->index(i, 0)), i);
+        }
+        _sourceRowsValid = true;
+    }
+    return _sourceRows.value(frame, -1);
+}
+
+void FrameGroupModel::onSourceAboutToBeReset() {
+    beginResetModel();
+
+    // the source is about to delete its frames, we must not keep references to them
+    qDeleteAll(_groups);
+    _groups.clear();
+    _contributions.clear();
+    _sourceRowsValid = false;
+}
+
+void FrameGroupModel::onSourceReset() {
+    rebuild();
+    endResetModel();
+}
+
+void FrameGroupModel::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last) {
+    if (parent.isValid()) {
+        return;
+    }
+
+    for (int i = first; i <= last; i++) {
+        removeFrame(_frameModel->frameAt(_frameModel->index(i, 0)), true);
+    }
+}
+
+void FrameGroupModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last) {
+    if (parent.isValid()) {
+        return;
+    }
+
+    _sourceRowsValid = false;
+    for (int i = first; i <= last; i++) {
+        addFrame(_frameModel->frameAt(_frameModel->index(i, 0)), true);
+    }
+}
+
+void FrameGroupModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+    if (!topLeft.isValid() || !bottomRight.isValid()) {
+        return;
+    }
+
+    for (int i = topLeft.row(); i <= bottomRight.row(); i++) {
+        Frame *frame = _frameModel->frameAt(_frameModel->index(i, 0));
+        if (!_contributions.contains(frame)) {
+            addFrame(frame, true);
+            continue;
+        }
+
+        const Contribution old = _contributions.value(frame);
+        const Contribution &current = contributionOf(frame);
+
+        // a new start time moves the frame, possibly into another group
+        if (old.key != current.key || old.startMillis != current.startMillis) {
+            removeFrame(frame, true);
+            addFrame(frame, true);
+            continue;
+        }
+
+        int row = groupRow(old.key);
+        Group *group = _groups.at(row);
+        if (old.stoppedMillis != current.stoppedMillis || old.active != current.active) {
+            group->stoppedMillis += current.stoppedMillis - old.stoppedMillis;
+            if (old.active && !current.active) {
+                group->activeFrames.removeOne(frame);
+            } else if (!old.active && current.active) {
+                group->activeFrames << frame;
+            }
+            _contributions.insert(frame, current);
+        }
+
+        const QModelIndex &groupIndex = index(row, 0, QModelIndex());
+        emit dataChanged(groupIndex.siblingAtColumn(FrameTableViewModel::COL_DURATION), groupIndex.siblingAtColumn(FrameTableViewModel::COL_DURATION));
+
+        int entryIndex = entryRow(group, frame, old.startMillis);
+        if (entryIndex >= 0) {
+            emit dataChanged(index(entryIndex, topLeft.column(), groupIndex), index(entryIndex, bottomRight.column(), groupIndex));
+        }
+    }
+}
+
+bool FrameGroupModel::isGroup(const QModelIndex &index) const {
+    return index.isValid() && index.internalPointer() == nullptr;
+}
+
+Frame *FrameGroupModel::frameAt(const QModelIndex &index) const {
+    if (!index.isValid() || isGroup(index)) {
+        return nullptr;
+    }
+
+    auto *group = static_cast<Group *>(index.internalPointer());
+    return group->entries.at(index.row()).frame;
+}
+
+QModelIndex FrameGroupModel::index(int row, int column, const QModelIndex &parent) const {
+    if (!hasIndex(row, column, parent)) {
+        return {};
+    }
+
+    if (!parent.isValid()) {
+        return createIndex(row, column);
+    }
+
+    if (isGroup(parent)) {
+        return createIndex(row, column, _groups.at(parent.row()));
+    }
+
+    return {};
+}
+
+QModelIndex FrameGroupModel::parent(const QModelIndex &child) const {
+    if (!child.isValid() || isGroup(child)) {
+        return {};
+    }
+
+    auto *group = static_cast<Group *>(child.internalPointer());
+    return createIndex(groupRow(group), 0);
+}
+
+int FrameGroupModel::rowCount(const QModelIndex &parent) const {
+    if (!parent.isValid()) {
+        return _groups.size();
+    }
+
+    if (isGroup(parent) && parent.column() == 0) {
+        return _groups.at(parent.row())->entries.size();
+    }
+
+    return 0;
+}
+
+int FrameGroupModel::columnCount(const QModelIndex &) const {
+    return FrameTableViewModel::COLUMN_COUNT;
+}
+
+bool FrameGroupModel::hasChildren(const QModelIndex &parent) const {
+    return rowCount(parent) > 0;
+}
+
+QModelIndex FrameGroupModel::mapToSource(const QModelIndex &proxyIndex) const {
+    Frame *frame = frameAt(proxyIndex);
+    if (!frame) {
+        return {};
+    }
+
+    int row = sourceRow(frame);
+    if (row < 0) {
+        return {};
+    }
+    return _frameModel->index(row, proxyIndex.column());
+}
+
+QModelIndex FrameGroupModel::mapFromSource(const QModelIndex &sourceIndex) const {
+    if (!sourceIndex.isValid()) {
+        return {};
+    }
+
+    Frame *frame = _frameModel->frameAt(sourceIndex);
+    if (!_contributions.contains(frame)) {
+        return {};
+    }
+
+    const Contribution &c = _contributions[frame];
+    int row = groupRow(c.key);
+    if (row >= _groups.size()) {
+        return {};
+    }
+
+    Group *group = _groups.at(row);
+    int entryIndex = entryRow(group, frame, c.startMillis);
+    if (entryIndex < 0) {
+        return {};
+    }
+    return createIndex(entryIndex, sourceIndex.column(), group);
+}
+
+QVariant FrameGroupModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    if (!isGroup(index)) {
+        return QAbstractProxyModel::data(index, role);
+    }
+
+    const Group *group = _groups.at(index.row());
+    const int column = index.column();
+
+    if (role == Qt::DisplayRole) {
+        switch (column) {
+            case FrameTableViewModel::COL_START_DATE:
+                return groupLabel(group);
+            case FrameTableViewModel::COL_DURATION:
+                return Timespan(group->totalMillis()).format();
+            case FrameTableViewModel::COL_NOTES:
+                return tr("%n entries", "", group->entries.size());
+            default:
+                break;
+        }
+    }
+
+    if (role == Qt::FontRole) {
+        QFont font;
+        if (column == FrameTableViewModel::COL_DURATION && Fonts::useMonospaceFont()) {
+            font = Fonts::monospaceFont();
+        }
+        font.setBold(true);
+        return font;
+    }
+
+    if (role == Qt::TextAlignmentRole && column == FrameTableViewModel::COL_DURATION) {
+        return QVariant(Qt::AlignRight + Qt::AlignVCenter);
+    }
+
+    if (role == Qt::TextColorRole && column == FrameTableViewModel::COL_DURATION && !group->activeFrames.isEmpty()) {
+        return QVariant(QColor(Qt::red));
+    }
+
+    if (role == SortValueRole) {
+        if (column == FrameTableViewModel::COL_START_DATE) {
+            return group->key;
+        }
+        if (column == FrameTableViewModel::COL_DURATION) {
+            return group->totalMillis();
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant FrameGroupModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    return sourceModel()->headerData(section, orientation, role);
+}
+
+Qt::ItemFlags FrameGroupModel::flags(const QModelIndex &index) const {
+    if (isGroup(index)) {
+        return Qt::ItemIsEnabled;
+    }
+    return QAbstractProxyModel::flags(index);
+}
@@ -0,0 +1,127 @@
+#ifndef TOM_UI_FRAMEGROUPMODEL_H
+#define TOM_UI_FRAMEGROUPMODEL_H
+
+#include <QtCore/QAbstractProxyModel>
+#include <QtCore/QDate>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+#include "data/Frame.h"
+#include "FrameTableViewModel.h"
+
+/**
+ * Tree proxy on top of FrameTableViewModel which groups the time entries by day or by week.
+ * Each group row carries the total duration and the number of entries of the group.
+ * The totals are updated incrementally when source rows are inserted, changed or removed,
+ * only a reset of the source model rebuilds the groups.
+ */
+class FrameGroupModel : public QAbstractProxyModel {
+Q_OBJECT
+
+public:
+    enum Grouping {
+        GroupByDay, GroupByWeek
+    };
+
+    FrameGroupModel(FrameTableViewModel *sourceModel, QObject *parent);
+
+    ~FrameGroupModel() override;
+
+    Grouping grouping() const;
+
+    void setGrouping(Grouping grouping);
+
+    bool isGroup(const QModelIndex &index) const;
+
+    Frame *frameAt(const QModelIndex &index) const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent) const override;
+
+    QModelIndex parent(const QModelIndex &child) const override;
+
+    int rowCount(const QModelIndex &parent) const override;
+
+    int columnCount(const QModelIndex &parent) const override;
+
+    bool hasChildren(const QModelIndex &parent) const override;
+
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+    QVariant data(const QModelIndex &index, int role) const override;
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+private slots:
+
+    void onSourceAboutToBeReset();
+
+    void onSourceReset();
+
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+private:
+    struct Entry {
+        qint64 startMillis;
+        Frame *frame;
+    };
+
+    struct Group {
+        QDate key;
+        // duration of all stopped frames, active frames are added when the value is requested
+        qint64 stoppedMillis = 0;
+        // sorted by start time, newest first
+        QVector<Entry> entries;
+        QVector<Frame *> activeFrames;
+
+        qint64 totalMillis() const;
+    };
+
+    // the values which a frame contributed to its group when it was last seen
+    struct Contribution {
+        QDate key;
+        qint64 startMillis;
+        qint64 stoppedMillis;
+        bool active;
+    };
+
+    Contribution contributionOf(Frame *frame) const;
+
+    QDate groupKey(const QDateTime &start) const;
+
+    QString groupLabel(const Group *group) const;
+
+    int groupRow(const Group *group) const;
+
+    int groupRow(const QDate &key) const;
+
+    static int entryRow(const Group *group, const Frame *frame, qint64 startMillis);
+
+    void addFrame(Frame *frame, bool notify);
+
+    void removeFrame(Frame *frame, bool notify);
+
+    void rebuild();
+
+    int sourceRow(const Frame *frame) const;
+
+    FrameTableViewModel *_frameModel;
+    Grouping _grouping;
+
+    // sorted by key, newest first
+    QVector<Group *> _groups;
+    QHash<const Frame *, Contribution> _contributions;
+
+    // lazily rebuilt mapping of frame to source row, invalidated by row insertions and removals
+    mutable QHash<const Frame *, int> _sourceRows;
+    mutable bool _sourceRowsValid;
+};
+
+#endif //TOM_UI_FRAMEGROUPMODEL_H
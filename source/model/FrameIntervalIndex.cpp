@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <limits>
+
+#include "FrameIntervalIndex.h"
+
+static const qint64 OPEN_END = std::numeric_limits<qint64>::max();
+static const qint64 NO_END = std::numeric_limits<qint64>::min();
+
+bool FrameIntervalIndex::Interval::operator<(const Interval &other) const {
+    return start < other.start || (start == other.start && frame < other.frame);
+}
+
+FrameIntervalIndex::FrameIntervalIndex() : _root(-1), _seed(0x2545f491) {
+}
+
+void FrameIntervalIndex::reset(const QList<Frame *> &frames) {
+    _nodes.clear();
+    _freeNodes.clear();
+    _stored.clear();
+    _root = -1;
+
+    std::vector<Interval> intervals;
+    intervals.reserve(frames.size());
+    for (auto frame : frames) {
+        if (frame->startTime.isValid()) {
+            const Interval &interval = intervalOf(frame);
+            intervals.push_back(interval);
+            _stored.insert(frame, interval);
+        }
+    }
+    std::sort(intervals.begin(), intervals.end());
+
+    // the sorted intervals are turned into a treap in linear time, the rightmost path is kept on a stack
+    _nodes.reserve(intervals.size());
+    std::vector<int> rightPath;
+    for (const auto &interval : intervals) {
+        const int node = newNode(interval);
+
+        int last = -1;
+        while (!rightPath.empty() && _nodes[rightPath.back()].priority < _nodes[node].priority) {
+            last = rightPath.back();
+            rightPath.pop_back();
+        }
+        _nodes[node].left = last;
+        if (!rightPath.empty()) {
+            _nodes[rightPath.back()].right = node;
+        }
+        rightPath.push_back(node);
+    }
+
+    if (!rightPath.empty()) {
+        _root = rightPath.front();
+        updateSubtree(_root);
+    }
+}
+
+void FrameIntervalIndex::clear() {
+    reset(QList<Frame *>());
+}
+
+void FrameIntervalIndex::insert(Frame *frame) {
+    if (_stored.contains(frame) || !frame->startTime.isValid()) {
+        return;
+    }
+
+    const Interval &interval = intervalOf(frame);
+    _root = insertNode(_root, newNode(interval));
+    _stored.insert(frame, interval);
+}
+
+void FrameIntervalIndex::remove(const Frame *frame) {
+    auto stored = _stored.find(frame);
+    if (stored == _stored.end()) {
+        return;
+    }
+
+    _root = removeNode(_root, stored.value());
+    _stored.erase(stored);
+}
+
+void FrameIntervalIndex::update(Frame *frame) {
+    auto stored = _stored.constFind(frame);
+    if (stored != _stored.constEnd()) {
+        const Interval &current = intervalOf(frame);
+        if (current.start == stored->start && current.end == stored->end) {
+            return;
+        }
+    }
+
+    remove(frame);
+    insert(frame);
+}
+
+QList<Frame *> FrameIntervalIndex::overlapping(const QDateTime &start, const QDateTime &end, const Frame *exclude) const {
+    QList<Frame *> result;
+    if (!start.isValid()) {
+        return result;
+    }
+
+    const qint64 endMillis = end.isValid() ? end.toMSecsSinceEpoch() : OPEN_END;
+    visitOverlapping(start.toMSecsSinceEpoch(), endMillis, [&result, exclude](const Interval &interval) {
+        if (interval.frame != exclude) {
+            result << interval.frame;
+        }
+        return true;
+    });
+    return result;
+}
+
+QList<Frame *> FrameIntervalIndex::overlapping(const Frame *frame) const {
+    QList<Frame *> result;
+
+    auto stored = _stored.constFind(frame);
+    if (stored != _stored.constEnd()) {
+        visitOverlapping(stored->start, stored->end, [&result, frame](const Interval &interval) {
+            if (interval.frame != frame) {
+                result << interval.frame;
+            }
+            return true;
+        });
+    }
+    return result;
+}
+
+bool FrameIntervalIndex::hasOverlap(const Frame *frame) const {
+    auto stored = _stored.constFind(frame);
+    if (stored == _stored.constEnd()) {
+        return false;
+    }
+
+    bool found = false;
+    visitOverlapping(stored->start, stored->end, [&found, frame](const Interval &interval) {
+        found = interval.frame != frame;
+        return !found;
+    });
+    return found;
+}
+
+QList<FrameIntervalIndex::Gap> FrameIntervalIndex::gaps(const QDate &day) const {
+    QList<Gap> result;
+    if (!day.isValid()) {
+        return result;
+    }
+
+    const qint64 dayStart = QDateTime(day, QTime(0, 0)).toMSecsSinceEpoch();
+    const qint64 dayEnd = QDateTime(day.addDays(1), QTime(0, 0)).toMSecsSinceEpoch();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // the intervals are visited in order of their start time
+    qint64 cursor = NO_END;
+    visitOverlapping(dayStart, dayEnd, [&](const Interval &interval) {
+        const qint64 start = qMax(interval.start, dayStart);
+        const qint64 end = qMin(qMin(interval.end, dayEnd), qMax(now, start));
+
+        if (cursor != NO_END && start > cursor) {
+            result << Gap(QDateTime::fromMSecsSinceEpoch(cursor), QDateTime::fromMSecsSinceEpoch(start));
+        }
+        cursor = qMax(cursor, end);
+        return true;
+    });
+    return result;
+}
+
+FrameIntervalIndex::Interval FrameIntervalIndex::intervalOf(Frame *frame) {
+    Interval interval;
+    interval.start = frame->startTime.toMSecsSinceEpoch();
+    interval.end = frame->isActive() ? OPEN_END : frame->stopTime.toMSecsSinceEpoch();
+    interval.frame = frame;
+    return interval;
+}
+
+template<typename Visitor>
+void FrameIntervalIndex::visitOverlapping(qint64 start, qint64 end, Visitor visit) const {
+    visitNode(_root, start, end, visit);
+}
+
+template<typename Visitor>
+bool FrameIntervalIndex::visitNode(int node, qint64 start, qint64 end, Visitor &visit) const {
+    // skip subtrees which end before the start of the range
+    if (node < 0 || _nodes[node].maxEnd <= start) {
+        return true;
+    }
+
+    const Node &current = _nodes[node];
+    if (!visitNode(current.left, start, end, visit)) {
+        return false;
+    }
+
+    // the right subtree starts after the range if this interval does
+    if (current.interval.start >= end) {
+        return true;
+    }
+    if (current.interval.end > start && !visit(current.interval)) {
+        return false;
+    }
+    return visitNode(current.right, start, end, visit);
+}
+
+int FrameIntervalIndex::newNode(const Interval &interval) {
+    const Node node{interval, interval.end, nextPriority(), -1, -1};
+    if (!_freeNodes.empty()) {
+        const int index = _freeNodes.back();
+        _freeNodes.pop_back();
+        _nodes[index] = node;
+        return index;
+    }
+
+    _nodes.push_back(node);
+    return static_cast<int>(_nodes.size()) - 1;
+}
+
+int FrameIntervalIndex::insertNode(int node, int inserted) {
+    if (node < 0) {
+        return inserted;
+    }
+
+    if (_nodes[inserted].priority > _nodes[node].priority) {
+        int before = -1;
+        int after = -1;
+        split(node, _nodes[inserted].interval, before, after);
+        _nodes[inserted].left = before;
+        _nodes[inserted].right = after;
+        updateMaxEnd(inserted);
+        return inserted;
+    }
+
+    if (_nodes[inserted].interval < _nodes[node].interval) {
+        _nodes[node].left = insertNode(_nodes[node].left, inserted);
+    } else {
+        _nodes[node].right = insertNode(_nodes[node].right, inserted);
+    }
+    updateMaxEnd(node);
+    return node;
+}
+
+int FrameIntervalIndex::removeNode(int node, const Interval &interval) {
+    if (node < 0) {
+        return node;
+    }
+
+    if (_nodes[node].interval.frame == interval.frame) {
+        const int replacement = merge(_nodes[node].left, _nodes[node].right);
+        _freeNodes.push_back(node);
+        return replacement;
+    }
+
+    if (interval < _nodes[node].interval) {
+        _nodes[node].left = removeNode(_nodes[node].left, interval);
+    } else {
+        _nodes[node].right = removeNode(_nodes[node].right, interval);
+    }
+    updateMaxEnd(node);
+    return node;
+}
+
+void FrameIntervalIndex::split(int node, const Interval &key, int &before, int &after) {
+    if (node < 0) {
+        before = -1;
+        after = -1;
+        return;
+    }
+
+    if (_nodes[node].interval < key) {
+        split(_nodes[node].right, key, _nodes[node].right, after);
+        before = node;
+    } else {
+        split(_nodes[node].left, key, before, _nodes[node].left);
+        after = node;
+    }
+    updateMaxEnd(node);
+}
+
+int FrameIntervalIndex::merge(int left, int right) {
+    if (left < 0 || right < 0) {
+        return left < 0 ? right : left;
+    }
+
+    if (_nodes[left].priority > _nodes[right].priority) {
+        _nodes[left].right = merge(_nodes[left].right, right);
+        updateMaxEnd(left);
+        return left;
+    }
+
+    _nodes[right].left = merge(left, _nodes[right].left);
+    updateMaxEnd(right);
+    return right;
+}
+
+void FrameIntervalIndex::updateMaxEnd(int node) {
+    Node &current = _nodes[node];
+    current.maxEnd = current.interval.end;
+    if (current.left >= 0) {
+        current.maxEnd = qMax(current.maxEnd, _nodes[current.left].maxEnd);
+    }
+    if (current.right >= 0) {
+        current.maxEnd = qMax(current.maxEnd, _nodes[current.right].maxEnd);
+    }
+}
+
+void FrameIntervalIndex::updateSubtree(int node) {
+    if (_nodes[node].left >= 0) {
+        updateSubtree(_nodes[node].left);
+    }
+    if (_nodes[node].right >= 0) {
+        updateSubtree(_nodes[node].right);
+    }
+    updateMaxEnd(node);
+}
+
+quint32 FrameIntervalIndex::nextPriority() {
+    // xorshift, the priorities only need to be independent of the order of the intervals
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return _seed;
+}
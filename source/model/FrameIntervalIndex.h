@@ -0,0 +1,110 @@
+#ifndef TOM_UI_FRAMEINTERVALINDEX_H
+#define TOM_UI_FRAMEINTERVALINDEX_H
+
+#include <vector>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+
+#include "data/Frame.h"
+
+/**
+ * Interval tree over the start and stop times of a list of frames.
+ * The intervals are kept in a treap ordered by start time, each node is augmented with the maximum stop time
+ * of its subtree. Inserts and removals are O(log n), an overlap query is O(log n + m) for m results.
+ * Active frames are treated as open-ended.
+ */
+class FrameIntervalIndex {
+public:
+    typedef QPair<QDateTime, QDateTime> Gap;
+
+    FrameIntervalIndex();
+
+    void reset(const QList<Frame *> &frames);
+
+    void clear();
+
+    void insert(Frame *frame);
+
+    void remove(const Frame *frame);
+
+    /**
+     * Updates the interval of a frame after its start or stop time was modified.
+     */
+    void update(Frame *frame);
+
+    /**
+     * @return The frames which overlap the range, the excluded frame isn't part of the result.
+     */
+    QList<Frame *> overlapping(const QDateTime &start, const QDateTime &end, const Frame *exclude = nullptr) const;
+
+    /**
+     * @return The frames which overlap the indexed interval of the frame.
+     */
+    QList<Frame *> overlapping(const Frame *frame) const;
+
+    bool hasOverlap(const Frame *frame) const;
+
+    /**
+     * @return The untracked ranges between the first and the last frame of the day.
+     */
+    QList<Gap> gaps(const QDate &day) const;
+
+private:
+    struct Interval {
+        qint64 start;
+        qint64 end;
+        Frame *frame;
+
+        bool operator<(const Interval &other) const;
+    };
+
+    struct Node {
+        Interval interval;
+        // the maximum end of the intervals of the subtree
+        qint64 maxEnd;
+        quint32 priority;
+        int left;
+        int right;
+    };
+
+    static Interval intervalOf(Frame *frame);
+
+    template<typename Visitor>
+    void visitOverlapping(qint64 start, qint64 end, Visitor visit) const;
+
+    template<typename Visitor>
+    bool visitNode(int node, qint64 start, qint64 end, Visitor &visit) const;
+
+    int newNode(const Interval &interval);
+
+    int insertNode(int node, int inserted);
+
+    int removeNode(int node, const Interval &interval);
+
+    /**
+     * Splits a subtree into the intervals before the key and the other intervals.
+     */
+    void split(int node, const Interval &key, int &before, int &after);
+
+    int merge(int left, int right);
+
+    void updateMaxEnd(int node);
+
+    void updateSubtree(int node);
+
+    quint32 nextPriority();
+
+    // the nodes are referenced by their index, removed nodes are reused
+    std::vector<Node> _nodes;
+    std::vector<int> _freeNodes;
+    int _root;
+    quint32 _seed;
+
+    // the interval which is stored for a frame, needed to locate it after the frame was modified
+    QHash<const Frame *, Interval> _stored;
+};
+
+#endif //TOM_UI_FRAMEINTERVALINDEX_H
@@ -0,0 +1,225 @@
+#include "FrameSelectionAggregate.h"
+
+FrameSelectionAggregate::FrameSelectionAggregate(TomControl *control,
+                                                 QItemSelectionModel *selectionModel,
+                                                 FrameResolver resolver,
+                                                 QObject *parent) : QObject(parent),
+                                                                    _control(control),
+                                                                    _selectionModel(selectionModel),
+                                                                    _resolver(std::move(resolver)),
+                                                                    _stoppedMillis(0),
+                                                                    _stoppedEarnings(0) {
+    connect(_selectionModel, &QItemSelectionModel::selectionChanged, this, &FrameSelectionAggregate::onSelectionChanged);
+
+    const QAbstractItemModel *model = _selectionModel->model();
+    connect(model, &QAbstractItemModel::modelReset, this, &FrameSelectionAggregate::clear);
+    connect(model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &FrameSelectionAggregate::onRowsAboutToBeRemoved);
+    connect(model, &QAbstractItemModel::dataChanged, this, &FrameSelectionAggregate::onDataChanged);
+
+    // the earnings depend on the hourly rates, which are inherited from the parent projects
+    auto resetRates = [this] {
+        _hourlyRates.clear();
+
+        const QList<Frame *> frames = _entries.keys();
+        for (auto frame : frames) {
+            remove(frame);
+            add(frame);
+        }
+        if (!frames.isEmpty()) {
+            emit changed();
+        }
+    };
+    connect(_control, &TomControl::projectUpdated, this, resetRates);
+    connect(_control, &TomControl::projectHierarchyChanged, this, resetRates);
+    connect(_control, &TomControl::dataResetNeeded, this, resetRates);
+}
+
+int FrameSelectionAggregate::count() const {
+    return _entries.size();
+}
+
+qint64 FrameSelectionAggregate::totalMillis() const {
+    qint64 total = _stoppedMillis;
+    for (auto frame : _activeFrames) {
+        total += frame->durationMillis(true);
+    }
+    return total;
+}
+
+qint64 FrameSelectionAggregate::minMillis() const {
+    qint64 min = _durations.isEmpty() ? -1 : _durations.firstKey();
+    for (auto frame : _activeFrames) {
+        qint64 millis = frame->durationMillis(true);
+        if (min < 0 || millis < min) {
+            min = millis;
+        }
+    }
+    return qMax(min, qint64(0));
+}
+
+qint64 FrameSelectionAggregate::maxMillis() const {
+    qint64 max = _durations.isEmpty() ? 0 : _durations.lastKey();
+    for (auto frame : _activeFrames) {
+        max = qMax(max, frame->durationMillis(true));
+    }
+    return max;
+}
+
+double FrameSelectionAggregate::earnings() const {
+    double total = _stoppedEarnings;
+    for (auto frame : _activeFrames) {
+        total += _entries.value(frame).earnings * frame->durationMillis(true);
+    }
+    return total;
+}
+
+bool FrameSelectionAggregate::hasActiveFrames() const {
+    return !_activeFrames.isEmpty();
+}
+
+void FrameSelectionAggregate::onSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected) {
+    bool modified = false;
+
+    for (const auto &range : deselected) {
+        for (int row = range.top(); row <= range.bottom(); row++) {
+            // with row selections a row may still be selected by one of its other columns
+            if (_selectionModel->rowIntersectsSelection(row, range.parent())) {
+                continue;
+            }
+
+            Frame *frame = _resolver(range.model()->index(row, 0, range.parent()));
+            modified |= frame && remove(frame);
+        }
+    }
+
+    for (const auto &range : selected) {
+        for (int row = range.top(); row <= range.bottom(); row++) {
+            Frame *frame = _resolver(range.model()->index(row, 0, range.parent()));
+            modified |= frame && add(frame);
+        }
+    }
+
+    if (modified) {
+        emit changed();
+    }
+}
+
+void FrameSelectionAggregate::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last) {
+    if (_entries.isEmpty()) {
+        return;
+    }
+
+    bool modified = false;
+    const QAbstractItemModel *model = _selectionModel->model();
+    for (int row = first; row <= last; row++) {
+        Frame *frame = _resolver(model->index(row, 0, parent));
+        modified |= frame && remove(frame);
+    }
+
+    if (modified) {
+        emit changed();
+    }
+}
+
+void FrameSelectionAggregate::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+    if (_entries.isEmpty()) {
+        return;
+    }
+
+    bool modified = false;
+    const QAbstractItemModel *model = _selectionModel->model();
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        Frame *frame = _resolver(model->index(row, 0, topLeft.parent()));
+        if (frame && remove(frame)) {
+            // durations, projects or the active state may have changed
+            add(frame);
+            modified = true;
+        }
+    }
+
+    // the live duration of active frames is updated with dataChanged, too
+    if (modified) {
+        emit changed();
+    }
+}
+
+void FrameSelectionAggregate::clear() {
+    bool modified = !_entries.isEmpty();
+
+    _entries.clear();
+    _durations.clear();
+    _activeFrames.clear();
+    _stoppedMillis = 0;
+    _stoppedEarnings = 0;
+
+    if (modified) {
+        emit changed();
+    }
+}
+
+bool FrameSelectionAggregate::add(Frame *frame) {
+    if (_entries.contains(frame)) {
+        return false;
+    }
+
+    const Entry &entry = entryOf(frame);
+    _entries.insert(frame, entry);
+
+    if (entry.active) {
+        _activeFrames << frame;
+    } else {
+        _durations[entry.millis]++;
+        _stoppedMillis += entry.millis;
+        _stoppedEarnings += entry.earnings;
+    }
+    return true;
+}
+
+bool FrameSelectionAggregate::remove(Frame *frame) {
+    auto it = _entries.find(frame);
+    if (it == _entries.end()) {
+        return false;
+    }
+
+    const Entry entry = it.value();
+    _entries.erase(it);
+
+    if (entry.active) {
+        _activeFrames.removeOne(frame);
+    } else {
+        auto count = _durations.find(entry.millis);
+        if (count != _durations.end() && --count.value() <= 0) {
+            _durations.erase(count);
+        }
+        _stoppedMillis -= entry.millis;
+        _stoppedEarnings -= entry.earnings;
+    }
+
+    if (_entries.isEmpty()) {
+        // avoid the accumulation of rounding errors
+        _stoppedEarnings = 0;
+    }
+    return true;
+}
+
+FrameSelectionAggregate::Entry FrameSelectionAggregate::entryOf(Frame *frame) {
+    const double ratePerMilli = hourlyRate(frame->projectID) / (60.0 * 60.0 * 1000.0);
+
+    Entry entry;
+    entry.active = frame->isActive();
+    entry.millis = entry.active ? 0 : frame->durationMillis(false);
+    // active frames store the rate, the earnings are calculated with the live duration
+    entry.earnings = entry.active ? ratePerMilli : ratePerMilli * entry.millis;
+    return entry;
+}
+
+double FrameSelectionAggregate::hourlyRate(const QString &projectID) {
+    auto cached = _hourlyRates.constFind(projectID);
+    if (cached != _hourlyRates.constEnd()) {
+        return cached.value();
+    }
+
+    const double rate = _control->appliedHourlyRate(projectID);
+    _hourlyRates.insert(projectID, rate);
+    return rate;
+}
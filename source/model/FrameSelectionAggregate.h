@@ -0,0 +1,84 @@
+#ifndef TOM_UI_FRAMESELECTIONAGGREGATE_H
+#define TOM_UI_FRAMESELECTIONAGGREGATE_H
+
+#include <functional>
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
+#include <QtCore/QItemSelectionModel>
+
+#include "data/Frame.h"
+#include "gotime/TomControl.h"
+
+/**
+ * Keeps the sum, count, minimum, maximum and earnings of the frames selected in a view.
+ * The values are updated with the deltas of the selection model, i.e. extending a large selection
+ * only costs the newly selected rows. Active frames are tracked separately and their live duration
+ * is added when the values are requested.
+ */
+class FrameSelectionAggregate : public QObject {
+Q_OBJECT
+
+public:
+    typedef std::function<Frame *(const QModelIndex &)> FrameResolver;
+
+    FrameSelectionAggregate(TomControl *control, QItemSelectionModel *selectionModel, FrameResolver resolver, QObject *parent);
+
+    int count() const;
+
+    qint64 totalMillis() const;
+
+    qint64 minMillis() const;
+
+    qint64 maxMillis() const;
+
+    double earnings() const;
+
+    bool hasActiveFrames() const;
+
+signals:
+
+    void changed();
+
+private slots:
+
+    void onSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
+
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+    void clear();
+
+private:
+    struct Entry {
+        qint64 millis;
+        double earnings;
+        bool active;
+    };
+
+    bool add(Frame *frame);
+
+    bool remove(Frame *frame);
+
+    Entry entryOf(Frame *frame);
+
+    double hourlyRate(const QString &projectID);
+
+    TomControl *_control;
+    QItemSelectionModel *_selectionModel;
+    FrameResolver _resolver;
+
+    QHash<Frame *, Entry> _entries;
+    // duration -> number of selected, stopped frames with this duration
+    QMap<qint64, int> _durations;
+    QList<Frame *> _activeFrames;
+
+    qint64 _stoppedMillis;
+    double _stoppedEarnings;
+
+    QHash<QString, double> _hourlyRates;
+};
+
+#endif //TOM_UI_FRAMESELECTIONAGGREGATE_H
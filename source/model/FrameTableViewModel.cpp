@@ -2,13 +2,16 @@
 #include <source/icons.h>
 #include <QtGui/QFont>
 #include <source/fonts.h>
+#include <QtConcurrent/QtConcurrent>
 
 #include "FrameTableViewModel.h"
 #include "UserRoles.h"
 
 FrameTableViewModel::FrameTableViewModel(TomControl *control, QObject *parent) : QAbstractTableModel(parent),
                                                                                  _control(control),
-                                                                                 _archiveIcon(Icons::timeEntryArchive().pixmap(16, 16, QIcon::Disabled)) {
+                                                                                 _archiveIcon(Icons::timeEntryArchive().pixmap(16, 16, QIcon::Disabled)),
+                                                                                 _revalidation(new QFutureWatcher<QList<Frame *>>(this)) {
+    connect(_revalidation, &QFutureWatcher<QList<Frame *>>::finished, this, &FrameTableViewModel::onFramesRevalidated);
 
     connect(_control, &TomControl::framesUpdated, this, &FrameTableViewModel::onFramesUpdates);
     connect(_control, &TomControl::framesRemoved, this, &FrameTableViewModel::onFramesRemoved);
@@ -22,11 +25,16 @@ FrameTableViewModel::FrameTableViewModel(TomControl *control, QObject *parent) :
     connect(_control, &TomControl::projectRemoved, this, &FrameTableViewModel::onProjectHierarchyChange);
     connect(_control, &TomControl::dataResetNeeded, [this] { this->loadFrames(Project()); });
 
-    _frameUpdateTimer = new QTimer(this);
-    connect(_frameUpdateTimer, &QTimer::timeout, this, &FrameTableViewModel::onUpdateActiveFrames);
+    _frameUpdateTask = _control->scheduler()->addTask("active frames", 1000, RefreshScheduler::ViewTask, this, [this] {
+        onUpdateActiveFrames();
+    }, false);
 }
 
 FrameTableViewModel::~FrameTableViewModel() {
+    if (_revalidationPending) {
+        _revalidation->waitForFinished();
+        qDeleteAll(_revalidation->result());
+    }
     qDeleteAll(_frames);
 }
 
@@ -41,7 +49,12 @@ void FrameTableViewModel::loadFrames(const Project &project) {
     qDeleteAll(_frames);
     _frames.clear();
 
-    _frames = _control->loadFrames(project.getID(), true, _showArchived);
+    _loadCount++;
+    const bool preloaded = usePreloadedFrames(project.getID());
+    if (!preloaded) {
+        _frames = _control->loadFrames(project.getID(), true, _showArchived);
+    }
+    _intervals.reset(_frames);
 
     endResetModel();
 
@@ -56,6 +69,101 @@ void FrameTableViewModel::loadFrames(const Project &project) {
             }
         }
     }
+
+    if (preloaded) {
+        const QString &projectID = project.getID();
+        const bool includeArchived = _showArchived;
+        _revalidationPending = true;
+        _revalidatedLoad = _loadCount;
+        _revalidation->setFuture(QtConcurrent::run([this, projectID, includeArchived] {
+            return _control->loadFrames(projectID, true, includeArchived);
+        }));
+    }
+}
+
+void FrameTableViewModel::preloadFrames(const QString &projectID, bool includeArchived, const QList<Frame> &frames) {
+    _hasPreloadedFrames = true;
+    _preloadedProjectID = projectID;
+    _preloadedArchived = includeArchived;
+    _preloadedFrames = frames;
+}
+
+bool FrameTableViewModel::usePreloadedFrames(const QString &projectID) {
+    // the preloaded frames are only used for the first project, which is loaded
+    const bool matching = _hasPreloadedFrames && _preloadedProjectID == projectID;
+    const QList<Frame> frames = _preloadedFrames;
+    _hasPreloadedFrames = false;
+    _preloadedFrames.clear();
+
+    // the archived frames would be missing if they're displayed now, but weren't preloaded
+    if (!matching || _revalidationPending || (_showArchived && !_preloadedArchived)) {
+        return false;
+    }
+
+    for (const auto &frame : frames) {
+        if (_showArchived || !frame.archived) {
+            _frames << new Frame(frame);
+        }
+    }
+    return true;
+}
+
+void FrameTableViewModel::onFramesRevalidated() {
+    _revalidationPending = false;
+    const QList<Frame *> &frames = _revalidation->result();
+
+    // the frames are outdated if another project was loaded in the meantime
+    if (_loadCount != _revalidatedLoad || isSameFrames(frames, _frames)) {
+        qDeleteAll(frames);
+        return;
+    }
+
+    stopTimer();
+    beginResetModel();
+    qDeleteAll(_frames);
+    _frames = frames;
+    _intervals.reset(_frames);
+    endResetModel();
+
+    for (auto *f : _frames) {
+        if (f->isActive()) {
+            startTimer();
+            break;
+        }
+    }
+}
+
+bool FrameTableViewModel::isSameFrames(const QList<Frame *> &a, const QList<Frame *> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    for (int i = 0; i < a.size(); i++) {
+        const Frame *x = a.at(i);
+        const Frame *y = b.at(i);
+        if (x->id != y->id || x->projectID != y->projectID || x->startTime != y->startTime || x->stopTime != y->stopTime
+            || x->lastUpdated != y->lastUpdated || x->notes != y->notes || x->tags != y->tags || x->archived != y->archived) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const Project &FrameTableViewModel::currentProject() const {
+    return _currentProject;
+}
+
+bool FrameTableViewModel::isShowingArchived() const {
+    return _showArchived;
+}
+
+QList<Frame> FrameTableViewModel::currentFrames() const {
+    QList<Frame> frames;
+    frames.reserve(_frames.size());
+    for (const auto *frame : _frames) {
+        frames << *frame;
+    }
+    return frames;
 }
 
 void FrameTableViewModel::onProjectHierarchyChange() {
@@ -177,12 +285,18 @@ bool FrameTableViewModel::removeRows(int row, int count, const QModelIndex &pare
         return false;
     }
 
+    QList<Frame *> neighbours;
+
     beginRemoveRows(parent, row, row + count - 1);
     for (int i = 0; i < count; i++) {
-        _frames.removeAt(row + i);
+        Frame *frame = _frames.takeAt(row);
+        neighbours << _intervals.overlapping(frame);
+        _intervals.remove(frame);
     }
     endRemoveRows();
 
+    emitOverlapChanged(neighbours);
+
     return true;
 }
 
@@ -335,6 +449,11 @@ QVariant FrameTableViewModel::data(const QModelIndex &index, int role) const {
                 return QVariant(QColor(Qt::red));
             }
         }
+        if (index.column() == COL_START || index.column() == COL_END) {
+            if (_intervals.hasOverlap(_frames.at(index.row()))) {
+                return QVariant(QColor(Qt::darkYellow));
+            }
+        }
     }
 
     if (role == Qt::TextAlignmentRole) {
@@ -376,6 +495,16 @@ QVariant FrameTableViewModel::data(const QModelIndex &index, int role) const {
         return frame->id;
     }
 
+    if (role == OverlapRole) {
+        return _intervals.hasOverlap(_frames.at(index.row()));
+    }
+
+    if (role == Qt::ToolTipRole && (index.column() == COL_START || index.column() == COL_END)) {
+        if (_intervals.hasOverlap(_frames.at(index.row()))) {
+            return tr("This time entry overlaps with another entry");
+        }
+    }
+
     return QVariant();
 }
 
@@ -463,10 +592,34 @@ bool FrameTableViewModel::setData(const QModelIndex &index, const QVariant &valu
         frame->stopTime = endTime;
         frame->notes = notes;
         emit dataChanged(index, index);
+
+        updateInterval(frame);
     }
     return ok;
 }
 
+const FrameIntervalIndex &FrameTableViewModel::intervalIndex() const {
+    return _intervals;
+}
+
+void FrameTableViewModel::updateInterval(Frame *frame) {
+    // the overlap state of the entries at the old and at the new position may change
+    QList<Frame *> neighbours = _intervals.overlapping(frame);
+    _intervals.update(frame);
+    neighbours << _intervals.overlapping(frame) << frame;
+
+    emitOverlapChanged(neighbours);
+}
+
+void FrameTableViewModel::emitOverlapChanged(const QList<Frame *> &frames) {
+    for (auto *frame : frames.toSet()) {
+        int row = _frames.indexOf(frame);
+        if (row >= 0) {
+            emit dataChanged(createIndex(row, COL_START), createIndex(row, COL_END));
+        }
+    }
+}
+
 int FrameTableViewModel::findRow(const QString &frameID) {
     int index = 0;
     for (const auto *frame : _frames) {
@@ -530,13 +683,11 @@ void FrameTableViewModel::setShowArchived(bool showArchived) {
 }
 
 void FrameTableViewModel::startTimer() {
-    if (!_frameUpdateTimer->isActive()) {
-        _frameUpdateTimer->start(1000);
-    }
+    _control->scheduler()->setTaskEnabled(_frameUpdateTask, true);
 }
 
 void FrameTableViewModel::stopTimer() {
-    _frameUpdateTimer->stop();
+    _control->scheduler()->setTaskEnabled(_frameUpdateTask, false);
 }
 
 void FrameTableViewModel::removeFrameRows(const QStringList &ids) {
@@ -563,6 +714,8 @@ void FrameTableViewModel::updateFrames(const QStringList &ids) {
                 if (id == frame->id) {
                     *current = *frame;
                     emit dataChanged(createIndex(row, FIRST_COL), createIndex(row, LAST_COL));
+
+                    updateInterval(current);
                 }
             }
         }
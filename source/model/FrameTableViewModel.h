@@ -2,11 +2,13 @@
 #define GOTIME_UI_FRAMETABLEVIEWMODEL_H
 
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QFutureWatcher>
 #include <QFont>
 #include <QIcon>
 
 #include "gotime/TomControl.h"
 #include "data/Frame.h"
+#include "FrameIntervalIndex.h"
 
 static const QString &FRAMES_MIME_TYPE = "application/x-tom-frames";
 
@@ -19,6 +21,22 @@ public:
 
     void loadFrames(const Project &project);
 
+    /**
+     * Displays the given frames instead of loading them if the project is loaded next, e.g. the frames of the
+     * startup snapshot. The frames are replaced with tom's frames, which are loaded in the background.
+     * @param includeArchived true if the frames include the archived frames.
+     */
+    void preloadFrames(const QString &projectID, bool includeArchived, const QList<Frame> &frames);
+
+    const Project &currentProject() const;
+
+    bool isShowingArchived() const;
+
+    /**
+     * @return A copy of the displayed frames.
+     */
+    QList<Frame> currentFrames() const;
+
     bool setData(const QModelIndex &index, const QVariant &value, int role) override;
 
     Qt::ItemFlags flags(const QModelIndex &index) const override;
@@ -35,6 +53,8 @@ public:
 
     int findRow(const QString &frameID);
 
+    const FrameIntervalIndex &intervalIndex() const;
+
     static const int COL_ARCHIVED = 0;
     static const int COL_START_DATE = 1;
     static const int COL_START = 2;
@@ -77,6 +97,8 @@ private slots:
 
     void onProjectHierarchyChange();
 
+    void onFramesRevalidated();
+
 private:
     void startTimer();
 
@@ -95,16 +117,35 @@ private:
     TomControl *_control;
 
     QList<Frame *> _frames;
+    FrameIntervalIndex _intervals;
     Project _currentProject;
 
     bool _showArchived = true;
-    QTimer *_frameUpdateTimer;
+    int _frameUpdateTask;
 
     QPixmap _archiveIcon;
 
+    bool _hasPreloadedFrames = false;
+    QString _preloadedProjectID;
+    bool _preloadedArchived = false;
+    QList<Frame> _preloadedFrames;
+    // loads tom's frames after preloaded frames were displayed
+    QFutureWatcher<QList<Frame *>> *_revalidation;
+    bool _revalidationPending = false;
+    quint64 _loadCount = 0;
+    quint64 _revalidatedLoad = 0;
+
+    bool usePreloadedFrames(const QString &projectID);
+
+    static bool isSameFrames(const QList<Frame *> &a, const QList<Frame *> &b);
+
     void removeFrameRows(const QStringList &ids);
 
     void updateFrames(const QStringList &ids);
+
+    void updateInterval(Frame *frame);
+
+    void emitOverlapChanged(const QList<Frame *> &frames);
 };
 
 
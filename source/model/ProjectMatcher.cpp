@@ -0,0 +1,218 @@
+#include <algorithm>
+
+#include <QtCore/QElapsedTimer>
+
+#include "ProjectMatcher.h"
+
+// the time of a single query, the names which weren't scored in time are left out
+static const qint64 QUERY_BUDGET_MILLIS = 10;
+
+static const int SCORE_CHAR = 1;
+static const int SCORE_CONSECUTIVE = 5;
+static const int SCORE_WORD_START = 8;
+static const int SCORE_SEGMENT_START = 10;
+static const int SCORE_MAX_GAP_PENALTY = 10;
+static const int SCORE_SUBSTRING = 20;
+static const int SCORE_LAST_SEGMENT_PREFIX = 30;
+static const int SCORE_LAST_SEGMENT_EXACT = 40;
+static const int SCORE_RECENT = 10;
+
+ProjectMatcher::ProjectMatcher() : _lastValid(false) {
+}
+
+void ProjectMatcher::reset(const QList<Project> &projects) {
+    _entries.clear();
+    _masks.clear();
+    _entryIndex.clear();
+    _lastValid = false;
+
+    _entries.reserve(static_cast<size_t>(projects.size()));
+    _masks.reserve(static_cast<size_t>(projects.size()));
+    for (const auto &project : projects) {
+        if (!project.isValid()) {
+            continue;
+        }
+
+        const QString &folded = project.getName().toLower();
+        _entryIndex.insert(project.getID(), static_cast<int>(_entries.size()));
+        _entries.push_back(Entry{project.getID(), folded, 0});
+        _masks.push_back(charMask(folded));
+    }
+}
+
+void ProjectMatcher::setRecentProjectIDs(const QStringList &projectIDs) {
+    for (auto &entry : _entries) {
+        entry.boost = 0;
+    }
+
+    for (int i = 0; i < projectIDs.size(); i++) {
+        auto index = _entryIndex.constFind(projectIDs.at(i));
+        if (index != _entryIndex.constEnd()) {
+            _entries[index.value()].boost = (projectIDs.size() - i) * SCORE_RECENT;
+        }
+    }
+}
+
+QVector<ProjectMatcher::Match> ProjectMatcher::match(const QString &query, int maxResults) {
+    QElapsedTimer timer;
+    timer.start();
+
+    // whitespace matches any gap
+    QString needle;
+    for (const QChar &c : query) {
+        if (!c.isSpace()) {
+            needle.append(c.toLower());
+        }
+    }
+    if (needle.isEmpty()) {
+        _lastValid = false;
+        return QVector<Match>();
+    }
+
+    // every match of the extended query is also a match of the previous query
+    const bool refine = _lastValid && needle.startsWith(_lastQuery);
+    const quint64 queryMask = charMask(needle);
+
+    std::vector<int> candidates;
+    if (refine) {
+        for (int index : _lastCandidates) {
+            if ((_masks[index] & queryMask) == queryMask) {
+                candidates.push_back(index);
+            }
+        }
+    } else {
+        const size_t count = _masks.size();
+        const quint64 *masks = _masks.data();
+        for (size_t i = 0; i < count; i++) {
+            if ((masks[i] & queryMask) == queryMask) {
+                candidates.push_back(static_cast<int>(i));
+            }
+        }
+    }
+
+    std::vector<int> matched;
+    std::vector<std::pair<int, int>> scored;
+    bool complete = true;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if ((i & 1023) == 1023 && timer.elapsed() > QUERY_BUDGET_MILLIS) {
+            complete = false;
+            break;
+        }
+
+        const int index = candidates[i];
+        const Entry &entry = _entries[index];
+        int value = 0;
+        if (score(entry.folded, needle, value)) {
+            matched.push_back(index);
+            scored.emplace_back(value + entry.boost, index);
+        }
+    }
+
+    _lastQuery = needle;
+    _lastCandidates.swap(matched);
+    _lastValid = complete;
+
+    // only the best matches are sorted, equal scores are sorted by name
+    auto better = [this](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+        if (a.first != b.first) {
+            return a.first > b.first;
+        }
+        return _entries[a.second].folded < _entries[b.second].folded;
+    };
+    const size_t resultSize = std::min(scored.size(), static_cast<size_t>(qMax(0, maxResults)));
+    std::partial_sort(scored.begin(), scored.begin() + resultSize, scored.end(), better);
+
+    QVector<Match> result;
+    result.reserve(static_cast<int>(resultSize));
+    for (size_t i = 0; i < resultSize; i++) {
+        result.append(Match{_entries[scored[i].second].id, scored[i].first});
+    }
+
+    return result;
+}
+
+quint64 ProjectMatcher::charBit(ushort c) {
+    if (c >= 'a' && c <= 'z') {
+        return Q_UINT64_C(1) << (c - 'a');
+    }
+    if (c >= '0' && c <= '9') {
+        return Q_UINT64_C(1) << (26 + c - '0');
+    }
+    // all other characters share the remaining bits
+    return Q_UINT64_C(1) << (36 + c % 28);
+}
+
+quint64 ProjectMatcher::charMask(const QString &folded) {
+    quint64 mask = 0;
+    const QChar *chars = folded.constData();
+    for (int i = 0; i < folded.length(); i++) {
+        mask |= charBit(chars[i].unicode());
+    }
+    return mask;
+}
+
+bool ProjectMatcher::isBoundary(const QString &folded, int pos) {
+    if (pos == 0) {
+        return true;
+    }
+
+    const QChar prev = folded.at(pos - 1);
+    return prev == '/' || prev == ' ' || prev == '-' || prev == '_' || prev == '.';
+}
+
+bool ProjectMatcher::score(const QString &folded, const QString &query, int &value) {
+    // matching at the boundaries is better in most cases, but may fail where the plain match doesn't
+    if (!subsequenceScore(folded, query, true, value) && !subsequenceScore(folded, query, false, value)) {
+        return false;
+    }
+
+    const int lastSegment = folded.lastIndexOf('/') + 1;
+    if (folded.length() - lastSegment == query.length() && folded.endsWith(query)) {
+        value += SCORE_LAST_SEGMENT_EXACT;
+    } else if (folded.midRef(lastSegment).startsWith(query)) {
+        value += SCORE_LAST_SEGMENT_PREFIX;
+    } else if (folded.contains(query)) {
+        value += SCORE_SUBSTRING;
+    }
+
+    // shorter names are better matches of the same characters
+    value -= folded.length() / 8;
+    return true;
+}
+
+bool ProjectMatcher::subsequenceScore(const QString &folded, const QString &query, bool preferBoundaries, int &value) {
+    value = 0;
+    int prev = -1;
+    for (int i = 0; i < query.length(); i++) {
+        const QChar c = query.at(i);
+        int pos = folded.indexOf(c, prev + 1);
+        if (pos < 0) {
+            return false;
+        }
+
+        // skip to the next occurrence at a boundary unless the match continues the previous one
+        if (preferBoundaries && pos != prev + 1 && !isBoundary(folded, pos)) {
+            for (int next = folded.indexOf(c, pos + 1); next >= 0; next = folded.indexOf(c, next + 1)) {
+                if (isBoundary(folded, next)) {
+                    pos = next;
+                    break;
+                }
+            }
+        }
+
+        value += SCORE_CHAR;
+        if (prev >= 0 && pos == prev + 1) {
+            value += SCORE_CONSECUTIVE;
+        } else if (prev >= 0) {
+            value -= qMin(pos - prev - 1, SCORE_MAX_GAP_PENALTY);
+        }
+
+        if (pos == 0 || folded.at(pos - 1) == '/') {
+            value += SCORE_SEGMENT_START;
+        } else if (isBoundary(folded, pos)) {
+            value += SCORE_WORD_START;
+        }
+        prev = pos;
+    }
+    return true;
+}
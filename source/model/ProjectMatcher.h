@@ -0,0 +1,77 @@
+#ifndef TOM_UI_PROJECTMATCHER_H
+#define TOM_UI_PROJECTMATCHER_H
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "data/Project.h"
+
+/**
+ * Ranked fuzzy matching of queries against the full names of the projects, e.g. "clprta" matches "client/project/task".
+ * The characters of the query have to appear in the name in the same order. Matches at the start of a path segment
+ * or a word and consecutive characters score higher, recently used projects are boosted.
+ * Each name has a 64 bit mask of the characters it contains. The masks are stored in a flat array and are compared
+ * with the mask of the query before any name is scored. A query which extends the previous query only checks the
+ * names, which matched the previous one.
+ */
+class ProjectMatcher {
+public:
+    struct Match {
+        QString projectID;
+        int score;
+    };
+
+    ProjectMatcher();
+
+    void reset(const QList<Project> &projects);
+
+    /**
+     * The projects are boosted by their position in the list, the first one is boosted most.
+     */
+    void setRecentProjectIDs(const QStringList &projectIDs);
+
+    /**
+     * The names are scored in the order of reset(). When a query takes longer than its budget, the remaining names
+     * aren't scored and the result is the best of the names scored so far, which may miss better matches.
+     * @return The best matches of the query, ordered by descending score.
+     */
+    QVector<Match> match(const QString &query, int maxResults = 50);
+
+private:
+    struct Entry {
+        QString id;
+        // lower-cased full name
+        QString folded;
+        int boost;
+    };
+
+    static quint64 charMask(const QString &folded);
+
+    static quint64 charBit(ushort c);
+
+    static bool isBoundary(const QString &folded, int pos);
+
+    /**
+     * @return false if the query isn't a subsequence of the name.
+     */
+    static bool score(const QString &folded, const QString &query, int &value);
+
+    static bool subsequenceScore(const QString &folded, const QString &query, bool preferBoundaries, int &value);
+
+    std::vector<Entry> _entries;
+    // separate from the entries to keep the prefilter a tight loop over contiguous memory
+    std::vector<quint64> _masks;
+    QHash<QString, int> _entryIndex;
+
+    // the entries matching the previous query, reused if the next query extends it
+    QString _lastQuery;
+    std::vector<int> _lastCandidates;
+    bool _lastValid;
+};
+
+#endif //TOM_UI_PROJECTMATCHER_H
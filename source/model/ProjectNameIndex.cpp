@@ -0,0 +1,121 @@
+#include <algorithm>
+
+#include "ProjectNameIndex.h"
+
+ProjectNameIndex::ProjectNameIndex() = default;
+
+void ProjectNameIndex::reset(const QList<Project> &projects) {
+    clear();
+
+    _entries.reserve(static_cast<size_t>(projects.size()));
+    for (const auto &project : projects) {
+        if (!project.isValid()) {
+            continue;
+        }
+
+        const int index = static_cast<int>(_entries.size());
+        _entries.push_back(Entry{project.getID(), project.getParentID(), project.getName().toLower()});
+        _entryIndex.insert(project.getID(), index);
+
+        const QString &name = _entries.back().name;
+        for (int i = 0; i + 3 <= name.length(); i++) {
+            std::vector<int> &posting = _postings[trigramKey(name.constData() + i)];
+            // a name may contain the same trigram more than once
+            if (posting.empty() || posting.back() != index) {
+                posting.push_back(index);
+            }
+        }
+    }
+}
+
+void ProjectNameIndex::clear() {
+    _entries.clear();
+    _entryIndex.clear();
+    _postings.clear();
+}
+
+bool ProjectNameIndex::isEmpty() const {
+    return _entries.empty();
+}
+
+QSet<QString> ProjectNameIndex::match(const QString &query) const {
+    QSet<QString> result;
+    const QString &needle = query.toLower();
+    if (needle.isEmpty()) {
+        return result;
+    }
+
+    if (needle.length() < 3) {
+        for (const auto &entry : _entries) {
+            if (entry.name.contains(needle)) {
+                result << entry.id;
+            }
+        }
+        return result;
+    }
+
+    // intersect the posting lists, starting with the shortest one
+    std::vector<const std::vector<int> *> postings;
+    for (int i = 0; i + 3 <= needle.length(); i++) {
+        auto posting = _postings.constFind(trigramKey(needle.constData() + i));
+        if (posting == _postings.constEnd()) {
+            return result;
+        }
+        postings.push_back(&posting.value());
+    }
+    std::sort(postings.begin(), postings.end(), [](const std::vector<int> *a, const std::vector<int> *b) {
+        return a->size() < b->size();
+    });
+
+    std::vector<int> candidates = *postings.front();
+    std::vector<int> intersection;
+    for (size_t i = 1; i < postings.size() && !candidates.empty(); i++) {
+        intersection.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), postings[i]->begin(), postings[i]->end(),
+                              std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+
+    // the trigrams may be in a different order in the name
+    for (int index : candidates) {
+        const Entry &entry = _entries[index];
+        if (entry.name.contains(needle)) {
+            result << entry.id;
+        }
+    }
+    return result;
+}
+
+QSet<QString> ProjectNameIndex::refine(const QSet<QString> &previousMatches, const QString &query) const {
+    QSet<QString> result;
+    const QString &needle = query.toLower();
+    for (const auto &id : previousMatches) {
+        auto index = _entryIndex.constFind(id);
+        if (index != _entryIndex.constEnd() && _entries[index.value()].name.contains(needle)) {
+            result << id;
+        }
+    }
+    return result;
+}
+
+QSet<QString> ProjectNameIndex::withAncestors(const QSet<QString> &projectIDs) const {
+    QSet<QString> result = projectIDs;
+    for (const auto &id : projectIDs) {
+        auto index = _entryIndex.constFind(id);
+        for (int depth = 0; index != _entryIndex.constEnd() && depth < 256; depth++) {
+            const QString &parentID = _entries[index.value()].parentID;
+            if (parentID.isEmpty() || result.contains(parentID)) {
+                // the ancestors of a known parent were already added
+                break;
+            }
+
+            result << parentID;
+            index = _entryIndex.constFind(parentID);
+        }
+    }
+    return result;
+}
+
+quint64 ProjectNameIndex::trigramKey(const QChar *chars) {
+    return (quint64(chars[0].unicode()) << 32) | (quint64(chars[1].unicode()) << 16) | quint64(chars[2].unicode());
+}
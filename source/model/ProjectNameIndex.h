@@ -0,0 +1,59 @@
+#ifndef TOM_UI_PROJECTNAMEINDEX_H
+#define TOM_UI_PROJECTNAMEINDEX_H
+
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+#include "data/Project.h"
+
+/**
+ * Substring index over the full names of the projects.
+ * The lower-cased names are indexed by their trigrams, a query intersects the posting lists of its trigrams and
+ * verifies the remaining candidates. Queries with less than three characters are matched against the names directly.
+ */
+class ProjectNameIndex {
+public:
+    ProjectNameIndex();
+
+    void reset(const QList<Project> &projects);
+
+    void clear();
+
+    bool isEmpty() const;
+
+    /**
+     * @return The IDs of the projects with a full name containing the query, case-insensitive.
+     */
+    QSet<QString> match(const QString &query) const;
+
+    /**
+     * Narrows the result of a previous query. The new query has to contain the previous query.
+     * @return The IDs of the previous matches which match the new query.
+     */
+    QSet<QString> refine(const QSet<QString> &previousMatches, const QString &query) const;
+
+    /**
+     * @return The IDs of the projects and of all their parent projects.
+     */
+    QSet<QString> withAncestors(const QSet<QString> &projectIDs) const;
+
+private:
+    struct Entry {
+        QString id;
+        QString parentID;
+        QString name;
+    };
+
+    static quint64 trigramKey(const QChar *chars);
+
+    std::vector<Entry> _entries;
+    QHash<QString, int> _entryIndex;
+    // trigram -> indexes of the entries containing it, in ascending order
+    QHash<quint64, std::vector<int>> _postings;
+};
+
+#endif //TOM_UI_PROJECTNAMEINDEX_H
@@ -1,11 +1,17 @@
+#include <QCollator>
 #include <QStringList>
 #include <QtCore>
 
 #include "ProjectTreeItem.h"
 
-ProjectTreeItem::ProjectTreeItem(const Project &project, const ProjectStatusManager *statusManager, ProjectTreeItem *parent) : _project(project),
-                                                                                                                               _statusManager(statusManager),
-                                                                                                                               _parentItem(parent) {
+ProjectTreeItem::ProjectTreeItem(const Project &project, ProjectStatusManager *statusManager, ProjectTreeItem *parent) : _project(project),
+                                                                                                                         _statusManager(statusManager),
+                                                                                                                         _parentItem(parent),
+                                                                                                                         _row(0),
+                                                                                                                         _statusSlot(statusManager->statusSlot(project.getID())),
+                                                                                                                         _childrenFetched(false),
+                                                                                                                         _sortKey(collationKey(project.getShortName())),
+                                                                                                                         _formattedVersion(0) {
     refreshWith(project);
 }
 
@@ -16,10 +22,15 @@ ProjectTreeItem::~ProjectTreeItem() {
 void ProjectTreeItem::appendChild(ProjectTreeItem *item) {
     _childItems.append(item);
     item->_parentItem = this;
+    item->_row = _childItems.size() - 1;
 }
 
 void ProjectTreeItem::removeChild(ProjectTreeItem *item) {
-    _childItems.removeOne(item);
+    int index = _childItems.indexOf(item);
+    if (index >= 0) {
+        _childItems.remove(index);
+        updateRows(index);
+    }
     item->_parentItem = nullptr;
 }
 
@@ -27,55 +38,81 @@ ProjectTreeItem *ProjectTreeItem::childAt(int row) {
     return _childItems.value(row);
 }
 
+bool ProjectTreeItem::containsChild(ProjectTreeItem *child) const {
+    return _childItems.contains(child);
+}
+
 int ProjectTreeItem::childCount() const {
     return _childItems.count();
 }
 
+bool ProjectTreeItem::childrenFetched() const {
+    return _childrenFetched;
+}
+
+void ProjectTreeItem::setChildrenFetched(bool fetched) {
+    _childrenFetched = fetched;
+}
+
 QVariant ProjectTreeItem::sortData(int column) const {
+    if (column == COL_NAME) {
+        return _projectName;
+    }
+    if (column >= FIRST_STATUS_COL_INDEX && column <= LAST_COL_INDEX) {
+        return statusMillis(column);
+    }
+    return QVariant();
+}
+
+const QCollatorSortKey &ProjectTreeItem::nameSortKey() const {
+    return _sortKey;
+}
+
+qint64 ProjectTreeItem::statusMillis(int column) const {
     switch (column) {
-        case COL_NAME:
-            return _projectName.toLower();
         case COL_TODAY:
-            return _statusManager->getStatus(_project.getID()).dayTotal.asMillis();
+            return status().dayTotal.asMillis();
         case COL_YESTERDAY:
-            return _statusManager->getStatus(_project.getID()).yesterdayTotal.asMillis();
+            return status().yesterdayTotal.asMillis();
         case COL_WEEK:
-            return _statusManager->getStatus(_project.getID()).weekTotal.asMillis();
+            return status().weekTotal.asMillis();
         case COL_MONTH:
-            return _statusManager->getStatus(_project.getID()).monthTotal.asMillis();
+            return status().monthTotal.asMillis();
         case COL_YEAR:
-            return _statusManager->getStatus(_project.getID()).yearTotal.asMillis();
+            return status().yearTotal.asMillis();
         case COL_TOTAL:
-            return _statusManager->getStatus(_project.getID()).allTotal.asMillis();
+            return status().allTotal.asMillis();
         default:
-            return QVariant();
+            return 0;
     }
 }
 
 QVariant ProjectTreeItem::data(int column) const {
-    switch (column) {
-        case COL_NAME:
-            return _projectName;
-        case COL_TODAY:
-            return _statusManager->getStatus(_project.getID()).dayTotal.formatShort();
-        case COL_YESTERDAY:
-            return _statusManager->getStatus(_project.getID()).yesterdayTotal.formatShort();
-        case COL_WEEK:
-            return _statusManager->getStatus(_project.getID()).weekTotal.formatShort();
-        case COL_MONTH:
-            return _statusManager->getStatus(_project.getID()).monthTotal.formatShort();
-        case COL_YEAR:
-            return _statusManager->getStatus(_project.getID()).yearTotal.formatShort();
-        case COL_TOTAL:
-            return _statusManager->getStatus(_project.getID()).allTotal.formatShort();
-        default:
-            return QVariant();
+    if (column == COL_NAME) {
+        return _projectName;
+    }
+
+    if (column >= FIRST_STATUS_COL_INDEX && column <= LAST_COL_INDEX) {
+        if (_formattedVersion != _statusManager->statusVersion(_statusSlot)) {
+            updateFormattedStatus();
+        }
+        return _formattedStatus[column - FIRST_STATUS_COL_INDEX];
+    }
+
+    return QVariant();
+}
+
+void ProjectTreeItem::updateFormattedStatus() const {
+    for (int column = FIRST_STATUS_COL_INDEX; column <= LAST_COL_INDEX; column++) {
+        _formattedStatus[column - FIRST_STATUS_COL_INDEX] = Timespan(statusMillis(column)).formatShort();
     }
+    _formattedVersion = _statusManager->statusVersion(_statusSlot);
 }
 
 bool ProjectTreeItem::setData(int column, const QVariant &value) {
     if (column == COL_NAME) {
         _projectName = value.toString();
+        _sortKey = collationKey(_projectName);
         return true;
     }
     return false;
@@ -87,7 +124,7 @@ ProjectTreeItem *ProjectTreeItem::parentItem() {
 
 int ProjectTreeItem::row() const {
     if (_parentItem) {
-        return _parentItem->_childItems.indexOf(const_cast<ProjectTreeItem *>(this));
+        return _row;
     }
 
     return 0;
@@ -97,25 +134,55 @@ const Project &ProjectTreeItem::getProject() const {
     return _project;
 }
 
+const ProjectStatus &ProjectTreeItem::status() const {
+    return _statusManager->statusAt(_statusSlot);
+}
+
 void ProjectTreeItem::refreshWith(const Project &project) {
+    if (project.getID() != _project.getID()) {
+        _statusSlot = _statusManager->statusSlot(project.getID());
+        _formattedVersion = 0;
+    }
     _project = project;
     _projectName = project.getShortName();
+    _sortKey = collationKey(_projectName);
+}
+
+QCollatorSortKey ProjectTreeItem::collationKey(const QString &name) {
+    // names which only differ by case are equal, like the lowercase names which were sorted before
+    static const QCollator collator = [] {
+        QCollator c;
+        c.setCaseSensitivity(Qt::CaseInsensitive);
+        return c;
+    }();
+    return collator.sortKey(name);
 }
 
 void ProjectTreeItem::insertChild(ProjectTreeItem *child, int index) {
     _childItems.insert(index, child);
     child->_parentItem = this;
+    updateRows(index);
 }
 
 bool ProjectTreeItem::removeChildAt(int index) {
     if (index < 0 || index >= _childItems.size()) {
         return false;
     }
-    _childItems.removeAt(index);
+    _childItems.remove(index);
+    updateRows(index);
     return true;
 }
 
 void ProjectTreeItem::reset() {
-    qDeleteAll<QList<ProjectTreeItem *>>(_childItems);
+    qDeleteAll(_childItems);
     _childItems.clear();
+    _childrenFetched = false;
+}
+
+void ProjectTreeItem::updateRows(int from) {
+    // a dropped item is inserted before the view removes it from its old row,
+    // walking backwards keeps the first row of an item which is temporarily contained twice
+    for (int i = _childItems.size() - 1; i >= from; i--) {
+        _childItems.at(i)->_row = i;
+    }
 }
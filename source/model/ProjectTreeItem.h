@@ -1,7 +1,9 @@
 #ifndef TREEITEM_H
 #define TREEITEM_H
 
+#include <QCollatorSortKey>
 #include <QList>
+#include <QVector>
 #include <QVariant>
 #include <data/Project.h>
 #include <gotime/ProjectStatus.h>
@@ -9,7 +11,7 @@
 
 class ProjectTreeItem {
 public:
-    explicit ProjectTreeItem(const Project &project, const ProjectStatusManager *statusManager, ProjectTreeItem *parentItem = nullptr);
+    explicit ProjectTreeItem(const Project &project, ProjectStatusManager *statusManager, ProjectTreeItem *parentItem = nullptr);
 
     ~ProjectTreeItem();
 
@@ -25,10 +27,29 @@ public:
 
     ProjectTreeItem *childAt(int row);
 
+    bool containsChild(ProjectTreeItem *child) const;
+
     int childCount() const;
 
+    /**
+     * @return true if the child items were created. Children are created on demand by ProjectTreeModel::fetchMore().
+     */
+    bool childrenFetched() const;
+
+    void setChildrenFetched(bool fetched);
+
     QVariant sortData(int column) const;
 
+    /**
+     * @return The collation key of the name, which is cached until the name changes.
+     */
+    const QCollatorSortKey &nameSortKey() const;
+
+    /**
+     * @return The tracked time of a status column in milliseconds.
+     */
+    qint64 statusMillis(int column) const;
+
     virtual QVariant data(int column) const;
 
     virtual bool setData(int column, const QVariant &value);
@@ -56,11 +77,32 @@ public:
 
 protected:
     Project _project;
-    const ProjectStatusManager *_statusManager;
+    ProjectStatusManager *_statusManager;
     ProjectTreeItem *_parentItem;
+    // index of this item in the children of the parent item
+    int _row;
+    // slot of the project's status in the status manager
+    int _statusSlot;
+    bool _childrenFetched;
 
-    QList<ProjectTreeItem *> _childItems;
+    QVector<ProjectTreeItem *> _childItems;
     QString _projectName;
+
+    const ProjectStatus &status() const;
+
+private:
+    void updateRows(int from);
+
+    void updateFormattedStatus() const;
+
+    static QCollatorSortKey collationKey(const QString &name);
+
+    // the key of the name for the system locale, used for sorting
+    QCollatorSortKey _sortKey;
+
+    // formatted values of the status columns, valid for the status version of the slot
+    mutable QString _formattedStatus[COL_COUNT - FIRST_STATUS_COL_INDEX];
+    mutable quint32 _formattedVersion;
 };
 
 #endif // TREEITEM_H
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <QtWidgets/QApplication>
 
 #include <QtGui/QColor>
@@ -28,6 +30,8 @@ ProjectTreeModel::ProjectTreeModel(TomControl *control, ProjectStatusManager *st
     if (showOverallProject) {
         _visibleRootItem = new ProjectTreeRootItem(_statusManager, _rootItem);
         _rootItem->appendChild(_visibleRootItem);
+        // the invisible root only contains the "All projects" item
+        _rootItem->setChildrenFetched(true);
     } else {
         _visibleRootItem = _rootItem;
     }
@@ -44,26 +48,186 @@ ProjectTreeModel::~ProjectTreeModel() {
     delete _rootItem;
 }
 
+QSharedPointer<ProjectTreeModel> ProjectTreeModel::shared(TomControl *control, ProjectStatusManager *statusManager) {
+    // the models are only used on the GUI thread
+    static QHash<TomControl *, QWeakPointer<ProjectTreeModel>> sharedModels;
+
+    QSharedPointer<ProjectTreeModel> model = sharedModels.value(control).toStrongRef();
+    if (!model) {
+        model = QSharedPointer<ProjectTreeModel>(new ProjectTreeModel(control, statusManager, true, nullptr, false, false));
+        model->loadCachedProjects();
+
+        // the tree of the main window updates its items itself, the shared model has to listen to the changes
+        // it never calls tom, the projects are loaded again by the main window after a reset of the data
+        ProjectTreeModel *sharedModel = model.data();
+        connect(control, &TomControl::projectCreated, sharedModel, &ProjectTreeModel::addProject);
+        connect(control, &TomControl::projectUpdated, sharedModel, &ProjectTreeModel::updateProject);
+        connect(control, &TomControl::projectRemoved, sharedModel, &ProjectTreeModel::removeProject);
+        connect(control, &TomControl::projectHierarchyChanged, sharedModel, &ProjectTreeModel::onProjectHierarchyChange);
+        connect(control, &TomControl::projectsCached, sharedModel, &ProjectTreeModel::loadCachedProjects);
+        sharedModels.insert(control, model);
+    }
+    return model;
+}
+
 void ProjectTreeModel::loadProjects() {
+    resetProjects(_control->loadProjects());
+}
+
+void ProjectTreeModel::loadCachedProjects() {
+    resetProjects(_control->cachedProjects());
+}
+
+void ProjectTreeModel::resetProjects(const QList<Project> &projects) {
     beginResetModel();
 
     _visibleRootItem->reset();
-    _projects = _control->loadProjects();
-    setupItem(_visibleRootItem, _projects);
+    _itemsByID.clear();
+    _projects = projects;
+    setupItems(_visibleRootItem, _projects);
 
     endResetModel();
 }
 
-void ProjectTreeModel::setupItem(ProjectTreeItem *parent, QList<Project> &projects) {
-    const auto &parentProject = parent->getProject();
-    for (const auto &p: projects) {
-        if (p.getParentID() == parentProject.getID()) {
-            auto *item = new ProjectTreeItem(p, _statusManager, parent);
-            parent->appendChild(item);
+void ProjectTreeModel::setupItems(ProjectTreeItem *root, const QList<Project> &projects) {
+    // bucket the projects by parent ID in a single pass
+    _childProjects.clear();
+    _parentIDs.clear();
+    _childProjects.reserve(projects.size());
+    _parentIDs.reserve(projects.size());
+    for (const auto &project : projects) {
+        _childProjects[project.getParentID()].append(project);
+        _parentIDs.insert(project.getID(), project.getParentID());
+    }
+
+    // the children are sorted by name to keep the initial sort of the proxy models cheap
+    for (auto &children : _childProjects) {
+        std::sort(children.begin(), children.end(), [](const Project &a, const Project &b) {
+            return isSortedBefore(a, b);
+        });
+    }
+
+    // only the top-level items are created, all other items are created when they're needed
+    fetchChildren(root, false);
+}
+
+bool ProjectTreeModel::isSortedBefore(const Project &a, const Project &b) {
+    return a.getShortName().compare(b.getShortName(), Qt::CaseInsensitive) < 0;
+}
+
+bool ProjectTreeModel::fetchChildren(ProjectTreeItem *parentItem, bool notify) {
+    if (parentItem->childrenFetched()) {
+        return false;
+    }
+    parentItem->setChildrenFetched(true);
+
+    const QVector<Project> &children = _childProjects.value(parentItem->getProject().getID());
+    if (children.isEmpty()) {
+        return false;
+    }
 
-            setupItem(item, projects);
+    const int first = parentItem->childCount();
+    if (notify) {
+        beginInsertRows(indexOfItem(parentItem), first, first + children.size() - 1);
+    }
+    for (const auto &project : children) {
+        auto *item = new ProjectTreeItem(project, _statusManager, parentItem);
+        parentItem->appendChild(item);
+        _itemsByID.insert(project.getID(), item);
+    }
+    if (notify) {
+        endInsertRows();
+    }
+    return true;
+}
+
+ProjectTreeItem *ProjectTreeModel::materialize(const QString &projectID, int depth) {
+    ProjectTreeItem *item = _itemsByID.value(projectID);
+    if (item || depth > 256 || !_parentIDs.contains(projectID)) {
+        return item;
+    }
+
+    // only the chain of ancestors is created
+    const QString &parentID = _parentIDs.value(projectID);
+    ProjectTreeItem *parentItem = parentID.isEmpty() ? _visibleRootItem : materialize(parentID, depth + 1);
+    if (!parentItem) {
+        return nullptr;
+    }
+
+    fetchChildren(parentItem, true);
+    return _itemsByID.value(projectID);
+}
+
+QModelIndex ProjectTreeModel::indexOfItem(ProjectTreeItem *item) const {
+    if (!item || item == _rootItem) {
+        return {};
+    }
+    return createIndex(item->row(), 0, item);
+}
+
+void ProjectTreeModel::addToBuckets(const Project &project, const QString &parentID) {
+    QVector<Project> &siblings = _childProjects[parentID];
+    siblings.insert(std::upper_bound(siblings.begin(), siblings.end(), project, &ProjectTreeModel::isSortedBefore), project);
+    _parentIDs.insert(project.getID(), parentID);
+}
+
+Project ProjectTreeModel::removeFromBuckets(const QString &projectID) {
+    auto parent = _parentIDs.find(projectID);
+    if (parent == _parentIDs.end()) {
+        return Project();
+    }
+
+    Project removed;
+    QVector<Project> &siblings = _childProjects[parent.value()];
+    for (int i = 0; i < siblings.size(); i++) {
+        if (siblings.at(i).getID() == projectID) {
+            removed = siblings.takeAt(i);
+            break;
         }
     }
+    _parentIDs.erase(parent);
+    return removed;
+}
+
+void ProjectTreeModel::removeSubprojectsFromBuckets(const QString &projectID) {
+    QStringList pending = QStringList() << projectID;
+    while (!pending.isEmpty()) {
+        for (const auto &child : _childProjects.take(pending.takeLast())) {
+            _parentIDs.remove(child.getID());
+            pending << child.getID();
+        }
+    }
+}
+
+bool ProjectTreeModel::hasChildren(const QModelIndex &parent) const {
+    if (parent.isValid() && parent.column() > ProjectTreeItem::COL_NAME) {
+        return false;
+    }
+
+    ProjectTreeItem *item = projectItem(parent);
+    if (!item) {
+        return false;
+    }
+    if (item->childrenFetched()) {
+        return item->childCount() > 0;
+    }
+    return !_childProjects.value(item->getProject().getID()).isEmpty();
+}
+
+bool ProjectTreeModel::canFetchMore(const QModelIndex &parent) const {
+    if (parent.isValid() && parent.column() > ProjectTreeItem::COL_NAME) {
+        return false;
+    }
+
+    ProjectTreeItem *item = projectItem(parent);
+    return item && !item->childrenFetched() && !_childProjects.value(item->getProject().getID()).isEmpty();
+}
+
+void ProjectTreeModel::fetchMore(const QModelIndex &parent) {
+    ProjectTreeItem *item = projectItem(parent);
+    if (item) {
+        fetchChildren(item, true);
+    }
 }
 
 QVariant ProjectTreeModel::data(const QModelIndex &index, int role) const {
@@ -82,7 +246,8 @@ QVariant ProjectTreeModel::data(const QModelIndex &index, int role) const {
             return QColor(Qt::red);
         }
 
-        if (index.column() >= ProjectTreeItem::COL_TODAY && item->data(index.column()).toString() == "0:00h") {
+        // values below a minute are displayed as 0:00h
+        if (index.column() >= ProjectTreeItem::COL_TODAY && item->statusMillis(index.column()) < 60 * 1000) {
             return QColor(Qt::lightGray);
         }
     }
@@ -277,33 +442,77 @@ void ProjectTreeModel::printProjects(int level, ProjectTreeItem *root) {
     }
 }
 
-QModelIndex ProjectTreeModel::getProjectRow(const QString &projectID) const {
-    const QModelIndexList &list = match(index(0, 0, QModelIndex()), IDRole, projectID, 1,
-                                        Qt::MatchExactly | Qt::MatchRecursive);
-    if (list.size() == 1) {
-        return list.first();
+QModelIndex ProjectTreeModel::getProjectRow(const QString &projectID) {
+    if (projectID.isEmpty()) {
+        // the id of the visible root item, which is only a row if the overall project is shown
+        return _visibleRootItem == _rootItem ? QModelIndex() : createIndex(_visibleRootItem->row(), 0, _visibleRootItem);
+    }
+
+    ProjectTreeItem *item = materialize(projectID);
+    if (!item) {
+        return {};
+    }
+    return createIndex(item->row(), 0, item);
+}
+
+void ProjectTreeModel::unindexItems(ProjectTreeItem *item) {
+    const QString &id = item->getProject().getID();
+    // only remove the mapping if it's pointing to this item
+    if (!id.isEmpty() && _itemsByID.value(id) == item) {
+        _itemsByID.remove(id);
+    }
+
+    for (int i = 0; i < item->childCount(); i++) {
+        unindexItems(item->childAt(i));
     }
-    return {};
 }
 
 void ProjectTreeModel::updateProject(const Project &project) {
-    const QModelIndex &row = getProjectRow(project.getID());
-    if (row.isValid()) {
-        ProjectTreeItem *item = projectItem(row);
-        if (item) {
-            item->refreshWith(project);
-            emit dataChanged(row, row.siblingAtColumn(ProjectTreeItem::LAST_COL_INDEX));
+    // items which weren't created yet are created from the updated bucket
+    auto parent = _parentIDs.constFind(project.getID());
+    if (parent != _parentIDs.constEnd()) {
+        for (auto &sibling : _childProjects[parent.value()]) {
+            if (sibling.getID() == project.getID()) {
+                sibling = project;
+                break;
+            }
         }
     }
+
+    ProjectTreeItem *item = _itemsByID.value(project.getID());
+    if (item && item->parentItem()) {
+        item->refreshWith(project);
+        const QModelIndex &row = indexOfItem(item);
+        emit dataChanged(row, row.siblingAtColumn(ProjectTreeItem::LAST_COL_INDEX));
+    }
 }
 
-void ProjectTreeModel::updateProjectStatus(const QString &projectID) {
-    const QModelIndex &row = getProjectRow(projectID);
-    if (row.isValid()) {
-        ProjectTreeItem *item = projectItem(row);
-        if (item) {
-            emit dataChanged(row.siblingAtColumn(ProjectTreeItem::FIRST_STATUS_COL_INDEX),
-                             row.siblingAtColumn(ProjectTreeItem::LAST_COL_INDEX));
+void ProjectTreeModel::updateProjectStatus(const QStringList &projectIDs) {
+    QHash<ProjectTreeItem *, QVector<int>> rowsByParent;
+    for (const auto &id : projectIDs) {
+        // the overall status is displayed by the visible root item
+        ProjectTreeItem *item = id == ProjectStatus::OVERALL_ID ? _visibleRootItem : _itemsByID.value(id);
+        if (item && item != _rootItem && item->parentItem()) {
+            rowsByParent[item->parentItem()] << item->row();
+        }
+    }
+
+    for (auto it = rowsByParent.begin(); it != rowsByParent.end(); ++it) {
+        ProjectTreeItem *parentItem = it.key();
+        QVector<int> &rows = it.value();
+        std::sort(rows.begin(), rows.end());
+
+        const QModelIndex &parent = parentItem == _rootItem ? QModelIndex() : createIndex(parentItem->row(), 0, parentItem);
+        for (int first = 0; first < rows.size();) {
+            // extend the range as long as the rows are contiguous
+            int last = first;
+            while (last + 1 < rows.size() && rows.at(last + 1) <= rows.at(last) + 1) {
+                last++;
+            }
+
+            emit dataChanged(index(rows.at(first), ProjectTreeItem::FIRST_STATUS_COL_INDEX, parent),
+                             index(rows.at(last), ProjectTreeItem::LAST_COL_INDEX, parent));
+            first = last + 1;
         }
     }
 }
@@ -313,27 +522,25 @@ Project ProjectTreeModel::projectAtIndex(const QModelIndex &index) {
 }
 
 void ProjectTreeModel::addProject(const Project &project) {
-    if (!project.isValid()) {
-        return;
-    }
-
-    const QModelIndex &row = getProjectRow(project.getID());
-    if (row.isValid()) {
+    if (!project.isValid() || _parentIDs.contains(project.getID())) {
         // project already exists
         return;
     }
 
-    const QList<Project> projects = QList<Project>() << project;
+    const QString &parentID = project.getParentID();
+    addToBuckets(project, parentID);
 
-    QModelIndex parentRow = index(0, 0, QModelIndex());
-    if (!project.getParentID().isEmpty()) {
-        parentRow = getProjectRow(project.getParentID());
+    // the item is created later on if the children of the parent weren't fetched yet
+    ProjectTreeItem *parentItem = parentID.isEmpty() ? _visibleRootItem : _itemsByID.value(parentID);
+    if (!parentItem || !parentItem->childrenFetched()) {
+        return;
     }
 
-    ProjectTreeItem *parentItem = projectItem(parentRow);
     int nextIndex = parentItem->childCount();
-    beginInsertRows(parentRow, nextIndex, nextIndex);
-    parentItem->appendChild(new ProjectTreeItem(project, _statusManager, parentItem));
+    beginInsertRows(indexOfItem(parentItem), nextIndex, nextIndex);
+    auto *item = new ProjectTreeItem(project, _statusManager, parentItem);
+    parentItem->appendChild(item);
+    _itemsByID.insert(project.getID(), item);
     endInsertRows();
 }
 
@@ -342,12 +549,17 @@ void ProjectTreeModel::removeProject(const Project &project) {
         return;
     }
 
-    const QModelIndex &row = getProjectRow(project.getID());
-    if (!row.isValid()) {
-        return;
-    }
+    // tom removes the subprojects, too
+    removeSubprojectsFromBuckets(project.getID());
+    removeFromBuckets(project.getID());
+    removeProjectRow(project.getID());
+}
 
-    removeRow(row.row(), row.parent());
+void ProjectTreeModel::removeProjectRow(const QString &projectID) {
+    ProjectTreeItem *item = _itemsByID.value(projectID);
+    if (item && item->parentItem()) {
+        removeRow(item->row(), indexOfItem(item->parentItem()));
+    }
 }
 
 /**
@@ -357,14 +569,14 @@ void ProjectTreeModel::removeProject(const Project &project) {
 void ProjectTreeModel::onProjectHierarchyChange(const QList<Project> &projects) {
     qDebug() << "onProjectHierarchyChange";
     for (const auto &updated: projects) {
-        const QModelIndex &row = getProjectRow(updated.getID());
-        const Project &stored = projectAtIndex(row);
+        const QString &oldParentID = _parentIDs.value(updated.getID());
 
         qDebug() << "new parent" << updated.getParentID();
-        qDebug() << "old parent" << stored.getParentID();
-        if (updated.getParentID() != stored.getParentID()) {
-            // move the row
-            removeProject(stored);
+        qDebug() << "old parent" << oldParentID;
+        if (updated.getParentID() != oldParentID) {
+            // move the row, the subprojects stay in the buckets and are fetched again when needed
+            removeFromBuckets(updated.getID());
+            removeProjectRow(updated.getID());
             addProject(updated);
         }
     }
@@ -425,7 +637,7 @@ bool ProjectTreeModel::handleDropProjectIDs(const QMimeData *data, Qt::DropActio
         return false;
     }
 
-    const QString &parentID = parentItem->getProject().getID();
+    const QString parentID = parentItem->getProject().getID();
 
     // don't move data in the model if the data couldn't be changed in tom
     // passing signalHierarchyChange = false because we're handling the change on our own here
@@ -439,12 +651,17 @@ bool ProjectTreeModel::handleDropProjectIDs(const QMimeData *data, Qt::DropActio
         return false;
     }
 
+    // the existing children have to be created before the dropped items are added
+    fetchChildren(parentItem, true);
+
     for (const auto &projectID : ids) {
         const QModelIndex &rowIndex = getProjectRow(projectID);
         if (!rowIndex.isValid()) {
             return false;
         }
 
+        addToBuckets(removeFromBuckets(projectID), parentID);
+
         // using moveRows here breaks our proxy model. The View class seems to remove the source rows on its own when move/moveInternal is used
         // therefore we're just inserting and let the View call removeRows()
         beginInsertRows(parent, 0, 0);
@@ -502,7 +719,9 @@ bool ProjectTreeModel::insertRows(int row, int count, const QModelIndex &parent)
 
     beginInsertRows(parent, row, row + count - 1);
     for (int i = 0; i < count; i++) {
-        parentItem->insertChild(new ProjectTreeItem(Project(), _statusManager, parentItem), i);
+        auto *item = new ProjectTreeItem(Project(), _statusManager, parentItem);
+        item->setChildrenFetched(true);
+        parentItem->insertChild(item, i);
     }
     endInsertRows();
 
@@ -519,16 +738,28 @@ bool ProjectTreeModel::removeRows(int row, int count, const QModelIndex &parent)
     ProjectTreeItem *parentItem = projectItem(parent);
     bool result = true;
 
+    QList<ProjectTreeItem *> removed;
     beginRemoveRows(parent, row, row + count - 1);
     for (int i = 0; i < count; i++) {
-        if (!parentItem->removeChildAt(row + i)) {
+        ProjectTreeItem *item = parentItem->childAt(row);
+        if (!parentItem->removeChildAt(row)) {
             qDebug() << "removing item failed" << i;
             result = false;
             break;
         }
+        removed << item;
     }
     endRemoveRows();
 
+    // items which were dropped onto another parent are still part of the tree,
+    // a drop into the same parent leaves a second reference to the item in the parent
+    for (auto *item : removed) {
+        if (item->parentItem() == parentItem && !parentItem->containsChild(item)) {
+            unindexItems(item);
+            delete item;
+        }
+    }
+
     return result;
 }
 
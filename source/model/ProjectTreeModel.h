@@ -2,6 +2,7 @@
 #define GOTIME_UI_PROJECTTREEMODEL_H
 
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QSharedPointer>
 
 #include "data/Project.h"
 #include "gotime/TomControl.h"
@@ -18,6 +19,13 @@ public:
 
     ~ProjectTreeModel() override;
 
+    /**
+     * @return The model of all projects, which is shared by the combo boxes of the dialogs. It's created from the
+     * projects cached by the control and is kept up-to-date. The model is deleted when the last reference is released.
+     * The widgets attach their own proxy models to sort and filter it.
+     */
+    static QSharedPointer<ProjectTreeModel> shared(TomControl *control, ProjectStatusManager *statusManager);
+
     Project projectAtIndex(const QModelIndex &index);
 
     QVariant data(const QModelIndex &index, int role) const override;
@@ -42,14 +50,31 @@ public:
 
     void updateProject(const Project &project);
 
-    void updateProjectStatus(const QString &projectID);
+    /**
+     * Updates the status columns of the given projects. Rows of the same parent are updated as ranges.
+     */
+    void updateProjectStatus(const QStringList &projectIDs);
+
+    /**
+     * @return The index of the project. The items of the project and of its parents are created if necessary.
+     */
+    QModelIndex getProjectRow(const QString &projectID);
+
+    bool hasChildren(const QModelIndex &parent) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
 
-    QModelIndex getProjectRow(const QString &projectID) const;
+    void fetchMore(const QModelIndex &parent) override;
 
 public slots:
 
     void loadProjects();
 
+    /**
+     * Displays the projects cached by the control, without calling tom.
+     */
+    void loadCachedProjects();
+
     void addProject(const Project &project);
 
     void removeProject(const Project &project);
@@ -78,6 +103,11 @@ private:
     ProjectTreeRootItem *_rootItem;
     ProjectTreeRootItem *_visibleRootItem;
     QList<Project> _projects;
+    // all items of the tree, mapped by project id
+    QHash<QString, ProjectTreeItem *> _itemsByID;
+    // the hierarchy of all projects, the items are created from it on demand
+    QHash<QString, QVector<Project>> _childProjects;
+    QHash<QString, QString> _parentIDs;
     QStringList _headers;
     bool _enableCheckboxes;
 
@@ -88,7 +118,27 @@ private:
     bool handleDropProjectIDs(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent);
     bool handleDropFrameIDs(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent);
 
-    void setupItem(ProjectTreeItem *parent, QList<Project> &projects);
+    void resetProjects(const QList<Project> &projects);
+
+    void setupItems(ProjectTreeItem *root, const QList<Project> &projects);
+
+    void unindexItems(ProjectTreeItem *item);
+
+    bool fetchChildren(ProjectTreeItem *parentItem, bool notify);
+
+    ProjectTreeItem *materialize(const QString &projectID, int depth = 0);
+
+    QModelIndex indexOfItem(ProjectTreeItem *item) const;
+
+    void addToBuckets(const Project &project, const QString &parentID);
+
+    Project removeFromBuckets(const QString &projectID);
+
+    void removeSubprojectsFromBuckets(const QString &projectID);
+
+    void removeProjectRow(const QString &projectID);
+
+    static bool isSortedBefore(const Project &a, const Project &b);
 
     static void printProjects(int level, ProjectTreeItem *root);
 };
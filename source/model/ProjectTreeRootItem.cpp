@@ -2,29 +2,18 @@
 
 #include <QApplication>
 
-ProjectTreeRootItem::ProjectTreeRootItem(const ProjectStatusManager *statusManager, ProjectTreeItem *parent) : ProjectTreeItem(Project::rootProject(), statusManager, parent) {}
+ProjectTreeRootItem::ProjectTreeRootItem(ProjectStatusManager *statusManager, ProjectTreeItem *parent) : ProjectTreeItem(Project::rootProject(), statusManager, parent) {
+    // the root item displays the overall status
+    _statusSlot = statusManager->statusSlot(ProjectStatus::OVERALL_ID);
+}
 
 ProjectTreeRootItem::~ProjectTreeRootItem() = default;
 
 QVariant ProjectTreeRootItem::data(int column) const {
-    switch (column) {
-        case COL_NAME:
-            return QApplication::tr("All projects");
-        case COL_YESTERDAY:
-            return _statusManager->getOverallStatus().yesterdayTotal.formatShort();
-        case COL_TODAY:
-            return _statusManager->getOverallStatus().dayTotal.formatShort();
-        case COL_WEEK:
-            return _statusManager->getOverallStatus().weekTotal.formatShort();
-        case COL_MONTH:
-            return _statusManager->getOverallStatus().monthTotal.formatShort();
-        case COL_YEAR:
-            return _statusManager->getOverallStatus().yearTotal.formatShort();
-        case COL_TOTAL:
-            return _statusManager->getOverallStatus().allTotal.formatShort();
-        default:
-            return QVariant();
+    if (column == COL_NAME) {
+        return QApplication::tr("All projects");
     }
+    return ProjectTreeItem::data(column);
 }
 
 bool ProjectTreeRootItem::setData(int, const QVariant &) {
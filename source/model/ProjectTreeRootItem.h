@@ -10,7 +10,7 @@
 
 class ProjectTreeRootItem  : public ProjectTreeItem {
 public:
-    explicit ProjectTreeRootItem(const ProjectStatusManager* statusManager, ProjectTreeItem* parent = nullptr);
+    explicit ProjectTreeRootItem(ProjectStatusManager* statusManager, ProjectTreeItem* parent = nullptr);
 
     virtual ~ProjectTreeRootItem();
 
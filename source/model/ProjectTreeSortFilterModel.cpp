@@ -1,16 +1,62 @@
 #include <QtCore>
 
 #include "ProjectTreeSortFilterModel.h"
+#include "ProjectTreeModel.h"
 #include "UserRoles.h"
 
-ProjectTreeSortFilterModel::ProjectTreeSortFilterModel(QObject *parent) : QSortFilterProxyModel(parent) {
+ProjectTreeSortFilterModel::ProjectTreeSortFilterModel(QObject *parent) : QSortFilterProxyModel(parent), _filtered(false) {
     setSortRole(UserRoles::SortValueRole);
 }
 
 bool ProjectTreeSortFilterModel::lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const {
+    // the names are compared by the collation keys cached by the items
+    auto *model = qobject_cast<ProjectTreeModel *>(sourceModel());
+    if (model && source_left.column() == ProjectTreeItem::COL_NAME) {
+        return model->projectItem(source_left)->nameSortKey().compare(model->projectItem(source_right)->nameSortKey()) < 0;
+    }
     return QSortFilterProxyModel::lessThan(source_left, source_right);
 }
 
 void ProjectTreeSortFilterModel::sort(int column, Qt::SortOrder order) {
     QSortFilterProxyModel::sort(column, order);
 }
+
+void ProjectTreeSortFilterModel::setAcceptedProjectIDs(const QSet<QString> &projectIDs) {
+    _acceptedIDs = projectIDs;
+    _filtered = true;
+    invalidateFilter();
+}
+
+void ProjectTreeSortFilterModel::clearAcceptedProjectIDs() {
+    if (_filtered) {
+        _acceptedIDs.clear();
+        _filtered = false;
+        invalidateFilter();
+    }
+}
+
+bool ProjectTreeSortFilterModel::isFiltered() const {
+    return _filtered;
+}
+
+void ProjectTreeSortFilterModel::setHiddenProjectIDs(const QSet<QString> &projectIDs) {
+    if (projectIDs != _hiddenIDs) {
+        _hiddenIDs = projectIDs;
+        invalidateFilter();
+    }
+}
+
+bool ProjectTreeSortFilterModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const {
+    if (!_filtered && _hiddenIDs.isEmpty()) {
+        return true;
+    }
+
+    // the rows of the subprojects are not checked if the parent is hidden
+    const QString &id = sourceModel()->index(source_row, 0, source_parent).data(UserRoles::IDRole).toString();
+    if (_hiddenIDs.contains(id)) {
+        return false;
+    }
+
+    // the accepted set already contains the parents of the matching projects
+    return !_filtered || id.isEmpty() || _acceptedIDs.contains(id);
+}
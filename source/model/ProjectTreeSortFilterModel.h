@@ -6,6 +6,7 @@
 #define TOM_UI_PROJECTTREESORTFILTERMODEL_H
 
 
+#include <QtCore/QSet>
 #include <QtCore/QSortFilterProxyModel>
 
 class ProjectTreeSortFilterModel : public QSortFilterProxyModel {
@@ -14,8 +15,29 @@ public:
 
     void sort(int column, Qt::SortOrder order) override;
 
+    /**
+     * Only displays the projects with the given IDs. The overall project is always displayed.
+     */
+    void setAcceptedProjectIDs(const QSet<QString> &projectIDs);
+
+    void clearAcceptedProjectIDs();
+
+    bool isFiltered() const;
+
+    /**
+     * Hides the projects with the given IDs and their subprojects.
+     */
+    void setHiddenProjectIDs(const QSet<QString> &projectIDs);
+
 protected:
     bool lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const override;
+
+    bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override;
+
+private:
+    QSet<QString> _acceptedIDs;
+    QSet<QString> _hiddenIDs;
+    bool _filtered;
 };
 
 
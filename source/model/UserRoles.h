@@ -5,7 +5,9 @@
 
 enum UserRoles {
     SortValueRole = Qt::UserRole,
-    IDRole
+    IDRole,
+    // true if a time entry overlaps with another time entry
+    OverlapRole
 };
 
 
@@ -0,0 +1,92 @@
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include "FrameExporter.h"
+
+// the progress callback is called after this number of frames
+static const qint64 PROGRESS_INTERVAL = 1000;
+
+FrameExporter::FrameExporter(TomControl *control, const Options &options) : _control(control),
+                                                                          _options(options) {
+    for (const auto &project : control->cachedProjects()) {
+        _projectNames.insert(project.getID(), project.getName());
+    }
+}
+
+bool FrameExporter::exportTo(QIODevice *device, const std::function<bool(qint64)> &progress) {
+    QTextStream out(device);
+    out.setCodec("UTF-8");
+    if (_options.format == CSV) {
+        out << "id,projectID,project,start,stop,durationSeconds,archived,notes\r\n";
+    }
+
+    qint64 rows = 0;
+    const bool ok = _control->streamFrames(_options.projectID, _options.includeSubprojects, _options.includeArchived,
+                                           [&](Frame &frame) {
+        const QDate &day = frame.startTime.date();
+        if ((_options.start.isValid() && day < _options.start) || (_options.end.isValid() && day > _options.end)) {
+            return true;
+        }
+
+        if (_options.format == CSV) {
+            writeCSV(out, frame);
+        } else {
+            writeJSONLine(out, frame);
+        }
+
+        if (++rows % PROGRESS_INTERVAL == 0 && progress && !progress(rows)) {
+            return false;
+        }
+        return out.status() == QTextStream::Ok;
+    });
+    out.flush();
+
+    if (progress && ok) {
+        progress(rows);
+    }
+    return ok && out.status() == QTextStream::Ok;
+}
+
+FrameExporter::Format FrameExporter::formatForFile(const QString &fileName) {
+    const QString &lower = fileName.toLower();
+    return lower.endsWith(".jsonl") || lower.endsWith(".ndjson") ? JSONLines : CSV;
+}
+
+void FrameExporter::writeCSV(QTextStream &out, Frame &frame) {
+    const qint64 seconds = frame.durationMillis(true) / 1000;
+
+    out << csvField(frame.id) << ','
+        << csvField(frame.projectID) << ','
+        << csvField(_projectNames.value(frame.projectID)) << ','
+        << frame.startTime.toString(Qt::ISODate) << ','
+        << (frame.isStopped() ? frame.stopTime.toString(Qt::ISODate) : QString()) << ','
+        << seconds << ','
+        << (frame.archived ? "true" : "false") << ','
+        << csvField(frame.notes) << "\r\n";
+}
+
+void FrameExporter::writeJSONLine(QTextStream &out, Frame &frame) {
+    QJsonObject item;
+    item["id"] = frame.id;
+    item["projectID"] = frame.projectID;
+    item["project"] = _projectNames.value(frame.projectID);
+    item["startTime"] = frame.startTime.toString(Qt::ISODate);
+    if (frame.isStopped()) {
+        item["stopTime"] = frame.stopTime.toString(Qt::ISODate);
+    }
+    item["durationSeconds"] = frame.durationMillis(true) / 1000;
+    item["archived"] = frame.archived;
+    item["notes"] = frame.notes;
+
+    out << QString::fromUtf8(QJsonDocument(item).toJson(QJsonDocument::Compact)) << '\n';
+}
+
+QString FrameExporter::csvField(const QString &value) {
+    // quoted as defined by RFC 4180
+    if (value.contains(',') || value.contains('"') || value.contains('\n') || value.contains('\r')) {
+        QString quoted = value;
+        quoted.replace("\"", "\"\"");
+        return '"' + quoted + '"';
+    }
+    return value;
+}
@@ -0,0 +1,65 @@
+#ifndef TOM_UI_FRAMEEXPORTER_H
+#define TOM_UI_FRAMEEXPORTER_H
+
+#include <functional>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDate>
+#include <QtCore/QHash>
+#include <QtCore/QIODevice>
+#include <QtCore/QTextStream>
+
+#include "gotime/TomControl.h"
+
+/**
+ * Exports the time entries of a project and its subprojects as CSV or as JSON Lines.
+ * The frames are written while tom's output is read, memory usage doesn't depend on the number of frames.
+ * The export may run on any thread, the project names are copied when the exporter is created.
+ */
+class FrameExporter {
+Q_DECLARE_TR_FUNCTIONS(FrameExporter)
+
+public:
+    enum Format {
+        CSV,
+        JSONLines
+    };
+
+    struct Options {
+        // an empty ID exports the frames of all projects
+        QString projectID;
+        bool includeSubprojects = true;
+        bool includeArchived = true;
+        // invalid dates don't limit the range
+        QDate start;
+        QDate end;
+        Format format = CSV;
+    };
+
+    FrameExporter(TomControl *control, const Options &options);
+
+    /**
+     * Writes the frames to the device.
+     * @param progress Called now and then with the number of written frames, returns false to cancel the export.
+     * @return true if all frames were written.
+     */
+    bool exportTo(QIODevice *device, const std::function<bool(qint64)> &progress = std::function<bool(qint64)>());
+
+    /**
+     * @return The format of the file name's extension, CSV if it's unknown.
+     */
+    static Format formatForFile(const QString &fileName);
+
+private:
+    void writeCSV(QTextStream &out, Frame &frame);
+
+    void writeJSONLine(QTextStream &out, Frame &frame);
+
+    static QString csvField(const QString &value);
+
+    TomControl *_control;
+    Options _options;
+    QHash<QString, QString> _projectNames;
+};
+
+#endif //TOM_UI_FRAMEEXPORTER_H
@@ -0,0 +1,49 @@
+#include "HtmlWriter.h"
+
+HtmlWriter::HtmlWriter(QIODevice *device) : _out(device) {
+    _out.setCodec("UTF-8");
+}
+
+HtmlWriter::~HtmlWriter() {
+    _out.flush();
+}
+
+void HtmlWriter::startDocument(const QString &title, const QString &css) {
+    _out << "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n";
+    element("title", title);
+    _out << "\n<style>\n" << css << "\n</style>\n</head>\n";
+    startElement("body");
+}
+
+void HtmlWriter::endDocument() {
+    while (!_open.isEmpty()) {
+        endElement();
+    }
+    _out << "</html>\n";
+    _out.flush();
+}
+
+void HtmlWriter::startElement(const char *name, const QString &cssClass) {
+    _out << '<' << name;
+    if (!cssClass.isEmpty()) {
+        _out << " class=\"" << cssClass.toHtmlEscaped() << '"';
+    }
+    _out << '>';
+    _open.append(name);
+}
+
+void HtmlWriter::endElement() {
+    if (!_open.isEmpty()) {
+        _out << "</" << _open.takeLast() << ">\n";
+    }
+}
+
+void HtmlWriter::element(const char *name, const QString &text, const QString &cssClass) {
+    startElement(name, cssClass);
+    this->text(text);
+    _out << "</" << _open.takeLast() << '>';
+}
+
+void HtmlWriter::text(const QString &text) {
+    _out << text.toHtmlEscaped();
+}
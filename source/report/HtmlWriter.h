@@ -0,0 +1,37 @@
+#ifndef TOM_UI_HTMLWRITER_H
+#define TOM_UI_HTMLWRITER_H
+
+#include <QtCore/QIODevice>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+
+/**
+ * Writes HTML to a device while it's generated. Text is escaped, the open elements are closed in order.
+ */
+class HtmlWriter {
+public:
+    explicit HtmlWriter(QIODevice *device);
+
+    ~HtmlWriter();
+
+    void startDocument(const QString &title, const QString &css);
+
+    void endDocument();
+
+    void startElement(const char *name, const QString &cssClass = QString());
+
+    void endElement();
+
+    /**
+     * Writes an element which only contains text.
+     */
+    void element(const char *name, const QString &text, const QString &cssClass = QString());
+
+    void text(const QString &text);
+
+private:
+    QTextStream _out;
+    QVector<const char *> _open;
+};
+
+#endif //TOM_UI_HTMLWRITER_H
@@ -4,7 +4,10 @@
 #include <source/commonModels/TranslatedStringlistModel.h>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QFileSystemModel>
+#include <QtWidgets/QMessageBox>
 #include <QCompleter>
+#include <QtCore/QBuffer>
+#include <QtConcurrent/QtConcurrent>
 
 #include "ProjectReportDialog.h"
 
@@ -12,13 +15,27 @@
 #include "source/view/ProjectTreeView.h"
 #include "source/model/UserRoles.h"
 #include "source/commonModels/FileSystemModel.h"
+#include "ReportEngine.h"
 
 ProjectReportDialog::ProjectReportDialog(const QList<Project> &projects, TomControl *control,
-                                         ProjectStatusManager *statusManager, QWidget *parent) : QDialog(parent),
+                                         ProjectStatusManager *statusManager, ReportCache *reportCache,
+                                         QWidget *parent) : QDialog(parent),
                                                                                                  _projects(),
                                                                                                  _control(control),
+                                                                                                 _reportCache(reportCache),
+                                                                                                 _rollupCube(statusManager->rollupCube()),
                                                                                                  _splitModel(new ReportSplitModel(this)),
-                                                                                                 _tempDir("tom-report") {
+                                                                                                 _tempDir("tom-report"),
+                                                                                                 _updateTimer(new QTimer(this)),
+                                                                                                 _reportProcess(nullptr),
+                                                                                                 _nativeReport(nullptr),
+                                                                                                 _reportGeneration(0),
+                                                                                                 _hasReport(false),
+                                                                                                 _bypassCache(false),
+                                                                                                 _textView(nullptr) {
+#ifdef TOM_WEBENGINE
+    _webView = nullptr;
+#endif
 
     setAttribute(Qt::WA_DeleteOnClose);
 
@@ -30,15 +47,22 @@ ProjectReportDialog::ProjectReportDialog(const QList<Project> &projects, TomCont
 
     setupUi(this);
 #ifdef TOM_REPORTS
-    _webView = new QWebEngineView(this);
-    _webView->setContextMenuPolicy(Qt::NoContextMenu);
-//    _webView->settings()->setAttribute(QWebEngineSettings::JavascriptEnabled, false);
-//    _webView->settings()->setAttribute(QWebEngineSettings::XSSAuditingEnabled, false);
-    previewFrame->layout()->addWidget(_webView);
-    _webView->show();
+    _textView = new QTextBrowser(this);
+    _textView->setOpenLinks(false);
+    _textView->setFrameShape(QFrame::NoFrame);
+    previewFrame->layout()->addWidget(_textView);
 #else
     previewFrame->hide();
 #endif
+#ifndef TOM_WEBENGINE
+    webPreviewCheckbox->hide();
+#endif
+    reportProgress->hide();
+
+    // controls like spin boxes emit many changes in a short time
+    _updateTimer->setSingleShot(true);
+    _updateTimer->setInterval(300);
+    connect(_updateTimer, &QTimer::timeout, this, &ProjectReportDialog::updateReport);
 
     // fix up widgets
     auto *completer = new QCompleter(this);
@@ -84,7 +108,12 @@ ProjectReportDialog::ProjectReportDialog(const QList<Project> &projects, TomCont
 
     // setup actions buttons
     auto *updateAction = new QAction("&Update report", this);
-    connect(updateAction, &QAction::triggered, this, &ProjectReportDialog::updateReport);
+    connect(updateAction, &QAction::triggered, [this] {
+        // active time entries are growing, even if the options and the data didn't change
+        _hasReport = false;
+        _bypassCache = true;
+        updateReport();
+    });
     updateAction->setShortcuts(QKeySequence::Refresh);
     updateAction->setShortcutVisibleInContextMenu(true);
 
@@ -101,49 +130,231 @@ ProjectReportDialog::ProjectReportDialog(const QList<Project> &projects, TomCont
     actionsButton->setMenu(actionsMenu);
 
     // connections
-    connect(projectsBox, QOverload<int>::of(&QComboBox::activated), this, &ProjectReportDialog::updateReport);
-    connect(subprojectsCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
+    connect(projectsBox, QOverload<int>::of(&QComboBox::activated), this, &ProjectReportDialog::scheduleReport);
+    connect(subprojectsCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+
+    connect(includeArchivedCheckBox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(dateFilterCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(dateStart, &QDateEdit::dateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(dateEnd, &QDateEdit::dateChanged, this, &ProjectReportDialog::scheduleReport);
+
+    connect(roundEntriesCheckBox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(frameRoundingMode, QOverload<int>::of(&QComboBox::activated), this, &ProjectReportDialog::scheduleReport);
+    connect(frameRoundingValue, QOverload<int>::of(&QSpinBox::valueChanged), this, &ProjectReportDialog::scheduleReport);
 
-    connect(includeArchivedCheckBox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(dateFilterCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(dateStart, &QDateEdit::dateChanged, this, &ProjectReportDialog::updateReport);
-    connect(dateEnd, &QDateEdit::dateChanged, this, &ProjectReportDialog::updateReport);
+    connect(templateBox, QOverload<int>::of(&QComboBox::activated), this, &ProjectReportDialog::scheduleReport);
 
-    connect(roundEntriesCheckBox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(frameRoundingMode, QOverload<int>::of(&QComboBox::activated), this, &ProjectReportDialog::updateReport);
-    connect(frameRoundingValue, QOverload<int>::of(&QSpinBox::valueChanged), this, &ProjectReportDialog::updateReport);
+    connect(_splitModel, &ReportSplitModel::itemStateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(_splitModel, &ReportSplitModel::dataChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(_splitModel, &ReportSplitModel::modelReset, this, &ProjectReportDialog::scheduleReport);
 
-    connect(templateBox, QOverload<int>::of(&QComboBox::activated), this, &ProjectReportDialog::updateReport);
+    connect(matrixTablesCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(showEmptyCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(showSummaryCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(showSalesCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(showTrackedCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(showUntrackedCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(useDecimalTimeFormat, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(nativeEngineCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::scheduleReport);
+    connect(webPreviewCheckbox, &QCheckBox::toggled, this, &ProjectReportDialog::updatePreviewBackend);
 
-    connect(_splitModel, &ReportSplitModel::itemStateChanged, this, &ProjectReportDialog::updateReport);
-    connect(_splitModel, &ReportSplitModel::dataChanged, this, &ProjectReportDialog::updateReport);
-    connect(_splitModel, &ReportSplitModel::modelReset, this, &ProjectReportDialog::updateReport);
+    // the native engine doesn't generate matrix tables
+    connect(nativeEngineCheckbox, &QCheckBox::toggled, matrixTablesCheckbox, &QWidget::setDisabled);
+    matrixTablesCheckbox->setDisabled(nativeEngineCheckbox->isChecked());
 
-    connect(matrixTablesCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(showEmptyCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(showSummaryCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(showSalesCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(showTrackedCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(showUntrackedCheckbox, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
-    connect(useDecimalTimeFormat, &QCheckBox::stateChanged, this, &ProjectReportDialog::updateReport);
+    updatePreviewBackend();
 
     QTimer::singleShot(500, this, &ProjectReportDialog::updateReport);
 }
 
+void ProjectReportDialog::scheduleReport() {
+    _updateTimer->start();
+}
+
 void ProjectReportDialog::updateReport() {
+    _updateTimer->stop();
+
     _projects.clear();
     Project project = projectsBox->selectedProject();
     if (project.isValid()) {
         _projects << project.getID();
     }
 
-    QString html = reportHTML(_tempFile);
+    const ReportOptions &options = currentOptions();
+    const bool running = _reportProcess || _nativeReport;
+    if (running ? options == _reportOptions : _hasReport && options == _reportOptions) {
+        return;
+    }
 
-#ifdef TOM_REPORTS
-    if (QFile::exists(_tempFile)) {
-        _webView->load(QUrl::fromLocalFile(_tempFile));
-    } else {
-        _webView->setHtml(html);
+    // the running report is outdated
+    if (_reportProcess) {
+        _reportProcess->cancel();
+        _reportProcess->deleteLater();
+        _reportProcess = nullptr;
+    }
+    if (_nativeReport) {
+        // the worker can't be interrupted, its result is dropped
+        _nativeReport->disconnect(this);
+        _nativeReport->deleteLater();
+        _nativeReport = nullptr;
+    }
+    if (running) {
+        reportProgress->hide();
+        previewFrame->setEnabled(true);
+    }
+
+    _reportOptions = options;
+
+    QString cached;
+    if (!_bypassCache && _reportCache->lookup(options, cached)) {
+        _hasReport = true;
+        showReport(cached);
+        return;
+    }
+    _bypassCache = false;
+
+    // the report is only cached if the data wasn't modified while it was generated
+    _reportGeneration = _control->dataGeneration();
+
+    if (options.nativeEngine) {
+        if (options.templateID == "timelog") {
+            // the totals are displayed while the time entries are loaded
+            ReportOptions totalsOptions = options;
+            totalsOptions.templateID = "default";
+            const QString &totals = rollupReport(totalsOptions);
+            if (!totals.isNull()) {
+                showReport(totals);
+            }
+        }
+
+        startNativeReport(options);
+        return;
+    }
+
+    _reportProcess = _control->startHtmlReport(_tempFile, options, this);
+    connect(_reportProcess, &ReportProcess::finished, this, &ProjectReportDialog::onReportFinished);
+
+    reportProgress->show();
+    previewFrame->setEnabled(false);
+}
+
+void ProjectReportDialog::onReportFinished(bool success, const QString &html) {
+    _reportProcess->deleteLater();
+    _reportProcess = nullptr;
+    _hasReport = success;
+
+    reportProgress->hide();
+    previewFrame->setEnabled(true);
+
+    if (!success) {
+        return;
+    }
+
+    // the report is written into the file if there's one
+    QString report = html;
+    QFile file(_tempFile);
+    if (!_tempFile.isEmpty() && file.open(QIODevice::ReadOnly)) {
+        report = QString::fromUtf8(file.readAll());
+        file.close();
+    }
+    _reportCache->insert(_reportOptions, _reportGeneration, report);
+
+    showReport(report);
+}
+
+void ProjectReportDialog::onNativeReportFinished() {
+    const QString &html = _nativeReport->result();
+    _nativeReport->deleteLater();
+    _nativeReport = nullptr;
+    _hasReport = !html.isNull();
+
+    reportProgress->hide();
+    previewFrame->setEnabled(true);
+
+    if (_hasReport) {
+        _reportCache->insert(_reportOptions, _reportGeneration, html);
+        showReport(html);
+    }
+}
+
+QString ProjectReportDialog::rollupReport(const ReportOptions &options) {
+    ReportEngine engine(_control, options);
+    if (!engine.loadRollup(_rollupCube)) {
+        return QString();
+    }
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    engine.writeHtml(&buffer);
+    return QString::fromUtf8(data);
+}
+
+void ProjectReportDialog::startNativeReport(const ReportOptions &options) {
+    // the rollup cube isn't thread-safe, its totals are added before the engine is passed to the worker
+    auto *engine = new ReportEngine(_control, options);
+    const bool needsFrames = !engine->loadRollup(_rollupCube);
+
+    _nativeReport = new QFutureWatcher<QString>(this);
+    connect(_nativeReport, &QFutureWatcher<QString>::finished, this, &ProjectReportDialog::onNativeReportFinished);
+    _nativeReport->setFuture(QtConcurrent::run([engine, needsFrames] {
+        QScopedPointer<ReportEngine> owner(engine);
+        if (needsFrames && !engine->loadFrames()) {
+            return QString();
+        }
+
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        engine->writeHtml(&buffer);
+        return QString::fromUtf8(data);
+    }));
+
+    reportProgress->show();
+    previewFrame->setEnabled(false);
+}
+
+void ProjectReportDialog::showReport(const QString &html) {
+    _reportHtml = html;
+
+#ifdef TOM_WEBENGINE
+    if (_webView && webPreviewCheckbox->isChecked()) {
+        // large reports can't be displayed by setHtml()
+        QFile file(_tempFile);
+        if (!_tempFile.isEmpty() && file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(html.toUtf8());
+            file.close();
+            _webView->load(QUrl::fromLocalFile(_tempFile));
+        } else {
+            _webView->setHtml(html);
+        }
+        return;
+    }
+#endif
+
+    if (_textView) {
+        _textView->setHtml(html);
+    }
+}
+
+void ProjectReportDialog::updatePreviewBackend() {
+#ifdef TOM_WEBENGINE
+    const bool web = webPreviewCheckbox->isChecked();
+    if (web && !_webView) {
+        _webView = new QWebEngineView(this);
+        _webView->setContextMenuPolicy(Qt::NoContextMenu);
+        previewFrame->layout()->addWidget(_webView);
+    }
+
+    if (_webView) {
+        _webView->setVisible(web);
+    }
+    if (_textView) {
+        _textView->setVisible(!web);
+    }
+
+    if (!_reportHtml.isEmpty()) {
+        showReport(_reportHtml);
     }
 #endif
 }
@@ -160,7 +371,24 @@ void ProjectReportDialog::saveReportHTML() {
 
     const QString &fileName = QFileDialog::getSaveFileName(this, tr("Save Report as HTML"), defaultFile, tr("HTML files (*.html *.htm);;All files (*)"));
     if (fileName != "") {
-        reportHTML(fileName);
+        const ReportOptions &options = currentOptions();
+        if (options.nativeEngine) {
+            // an incomplete report must not be saved as if it was complete
+            ReportEngine engine(_control, options);
+            if (!engine.loadRollup(_rollupCube) && !engine.loadFrames()) {
+                QMessageBox::warning(this, tr("Save failed"), tr("The time entries couldn't be loaded from tom, the report wasn't saved."));
+                return;
+            }
+
+            QFile file(fileName);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                QMessageBox::warning(this, tr("Save failed"), tr("The report couldn't be saved to %1.").arg(fileName));
+                return;
+            }
+            engine.writeHtml(&file);
+        } else {
+            _control->htmlReport(fileName, options);
+        }
     }
 }
 
@@ -286,46 +514,41 @@ void ProjectReportDialog::writeSettings(QSettings &settings, QObject *child) {
     }
 }
 
-QString ProjectReportDialog::reportHTML(const QString &filename) const {
-    QStringList splits = _splitModel->checkedItems();
-
-    int frameRoundingMin = frameRoundingValue->value();
+ReportOptions ProjectReportDialog::currentOptions() const {
+    ReportOptions options;
+    options.projectIDs = _projects;
+    options.includeSubprojects = subprojectsCheckbox->isChecked();
+    options.splits = _splitModel->checkedItems();
 
     const QString &frameModeText = frameRoundingMode->currentData(Qt::EditRole).toString();
-    TimeRoundingMode frameMode = NONE;
     if (roundEntriesCheckBox->isChecked()) {
         if (frameModeText == "up") {
-            frameMode = UP;
+            options.frameRoundingMode = UP;
         } else if (frameModeText == "down") {
-            frameMode = DOWN;
+            options.frameRoundingMode = DOWN;
         } else if (frameModeText == "up or down") {
-            frameMode = NEAREST;
+            options.frameRoundingMode = NEAREST;
         }
     }
+    options.frameRoundingMinutes = frameRoundingValue->value();
 
-    QDate start;
-    QDate end;
     if (dateFilterCheckbox->isChecked()) {
-        start = dateStart->date();
-        end = dateEnd->date();
+        options.start = dateStart->date();
+        options.end = dateEnd->date();
     }
 
-    const QString &templateId = templateBox->currentData(Qt::EditRole).toString();
-
-    return _control->htmlReport(filename, _projects,
-                                subprojectsCheckbox->isChecked(),
-                                start, end, frameMode, frameRoundingMin,
-                                splits,
-                                templateId,
-                                matrixTablesCheckbox->isChecked(),
-                                showEmptyCheckbox->isChecked(),
-                                showSummaryCheckbox->isChecked(),
-                                includeArchivedCheckBox->isChecked(),
-                                titleEdit->text(), descriptionEdit->toPlainText(),
-                                showSalesCheckbox->isChecked(),
-                                showTrackedCheckbox->isChecked(),
-                                showUntrackedCheckbox->isChecked(),
-                                cssFileEdit->text(),
-                                useDecimalTimeFormat->isChecked());
+    options.templateID = templateBox->currentData(Qt::EditRole).toString();
+    options.matrixTables = matrixTablesCheckbox->isChecked();
+    options.showEmpty = showEmptyCheckbox->isChecked();
+    options.showSummary = showSummaryCheckbox->isChecked();
+    options.includeArchived = includeArchivedCheckBox->isChecked();
+    options.title = titleEdit->text();
+    options.description = descriptionEdit->toPlainText();
+    options.showSales = showSalesCheckbox->isChecked();
+    options.showTracked = showTrackedCheckbox->isChecked();
+    options.showUntracked = showUntrackedCheckbox->isChecked();
+    options.cssFile = cssFileEdit->text();
+    options.decimalTimeFormat = useDecimalTimeFormat->isChecked();
+    options.nativeEngine = nativeEngineCheckbox->isChecked();
+    return options;
 }
-
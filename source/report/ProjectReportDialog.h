@@ -1,10 +1,12 @@
 #ifndef TOM_UI_REPORTDIALOG_H
 #define TOM_UI_REPORTDIALOG_H
 
+#include <QtCore/QFutureWatcher>
 #include <QtWidgets/QDialog>
+#include <QtWidgets/QTextBrowser>
 #include <QStringListModel>
 
-#ifdef TOM_REPORTS
+#ifdef TOM_WEBENGINE
 
 #include <QtWebEngineWidgets/QWebEngineView>
 
@@ -16,26 +18,56 @@
 #include "source/gotime/ProjectStatusManager.h"
 #include "source/model/ProjectTreeModel.h"
 #include "reportsplitmodel.h"
+#include "ReportCache.h"
 
 class ProjectReportDialog : public QDialog, private Ui::ReportDialog {
     Q_OBJECT
 public:
-    ProjectReportDialog(const QList<Project> &projects, TomControl *control, ProjectStatusManager *statusManager, QWidget *parent);
+    ProjectReportDialog(const QList<Project> &projects, TomControl *control, ProjectStatusManager *statusManager, ReportCache *reportCache,
+                        QWidget *parent);
 
     void done(int i) override;
 
 private slots:
 
+    /**
+     * Updates the report after the controls didn't change for a short while.
+     */
+    void scheduleReport();
+
     void updateReport();
 
+    void onReportFinished(bool success, const QString &html);
+
+    void onNativeReportFinished();
+
     void saveReportHTML();
 
     void projectIndexSelected(const QModelIndex &index);
 
+    /**
+     * Switches between the rich text and the web preview. The web view is only created when it's used first.
+     */
+    void updatePreviewBackend();
+
 private:
     void moveSplitSelection(int delta);
 
-    QString reportHTML(const QString& filename) const;
+    ReportOptions currentOptions() const;
+
+    void showReport(const QString &html);
+
+    /**
+     * Generates the report with ReportEngine from the totals of the rollup cube.
+     * @return The HTML of the report, a null string if the cube can't answer the options.
+     */
+    QString rollupReport(const ReportOptions &options);
+
+    /**
+     * Generates the report with ReportEngine in the background. Only the totals of the rollup cube are read
+     * in the GUI thread, the frames are loaded and the HTML is written by a worker.
+     */
+    void startNativeReport(const ReportOptions &options);
 
 protected:
     void readSettings();
@@ -50,12 +82,27 @@ private:
 
     QStringList _projects;
     TomControl *_control;
+    ReportCache *_reportCache;
+    RollupCube *_rollupCube;
     ReportSplitModel *_splitModel;
 
     QTemporaryDir _tempDir;
     QString _tempFile;
 
-#ifdef TOM_REPORTS
+    QTimer *_updateTimer;
+    // the report which is currently generated
+    ReportProcess *_reportProcess;
+    QFutureWatcher<QString> *_nativeReport;
+    ReportOptions _reportOptions;
+    // the data generation at the start of the report
+    quint64 _reportGeneration;
+    bool _hasReport;
+    bool _bypassCache;
+    // the displayed report, to switch the preview without generating it again
+    QString _reportHtml;
+
+    QTextBrowser *_textView;
+#ifdef TOM_WEBENGINE
     QWebEngineView *_webView;
 #endif
 };
@@ -0,0 +1,106 @@
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include "ReportCache.h"
+
+ReportCache::ReportCache(TomControl *control, bool diskCache, QObject *parent) : QObject(parent),
+                                                                               _control(control),
+                                                                               _generation(control->dataGeneration()),
+                                                                               _memory(8 * 1024) {
+    if (diskCache) {
+        _diskDir.reset(new QTemporaryDir(QDir(QDir::tempPath()).filePath("tom-report-cache-XXXXXX")));
+        if (!_diskDir->isValid()) {
+            qWarning() << "unable to create the report cache directory:" << _diskDir->errorString();
+            _diskDir.reset();
+        }
+    }
+}
+
+bool ReportCache::lookup(const ReportOptions &options, QString &html) {
+    checkGeneration();
+
+    const QByteArray &hash = key(options);
+    if (QString *cached = _memory.object(hash)) {
+        html = *cached;
+        return true;
+    }
+
+    if (_diskDir) {
+        QFile file(diskPath(hash));
+        if (file.open(QIODevice::ReadOnly)) {
+            html = QString::fromUtf8(file.readAll());
+            _memory.insert(hash, new QString(html), qMax(1, html.size() / 1024));
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReportCache::insert(const ReportOptions &options, quint64 generation, const QString &html) {
+    checkGeneration();
+    if (generation != _generation) {
+        // the report was generated from outdated data
+        return;
+    }
+
+    const QByteArray &hash = key(options);
+    _memory.insert(hash, new QString(html), qMax(1, html.size() / 1024));
+
+    if (_diskDir) {
+        QFile file(diskPath(hash));
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(html.toUtf8());
+        }
+    }
+}
+
+void ReportCache::remove(const ReportOptions &options) {
+    checkGeneration();
+
+    const QByteArray &hash = key(options);
+    _memory.remove(hash);
+    if (_diskDir) {
+        QFile::remove(diskPath(hash));
+    }
+}
+
+void ReportCache::clear() {
+    _memory.clear();
+    if (_diskDir) {
+        QDir dir(_diskDir->path());
+        for (const auto &name : dir.entryList(QStringList() << "*.html", QDir::Files)) {
+            dir.remove(name);
+        }
+    }
+}
+
+QByteArray ReportCache::key(const ReportOptions &options) const {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << _generation
+        << options.projectIDs << options.includeSubprojects
+        << options.start << options.end
+        << static_cast<qint32>(options.frameRoundingMode) << options.frameRoundingMinutes
+        << options.splits << options.templateID
+        << options.matrixTables << options.showEmpty << options.showSummary << options.includeArchived
+        << options.title << options.description
+        << options.showSales << options.showTracked << options.showUntracked
+        << options.cssFile << options.decimalTimeFormat << options.nativeEngine;
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+QString ReportCache::diskPath(const QByteArray &key) const {
+    return QDir(_diskDir->path()).filePath(QString::fromLatin1(key) + ".html");
+}
+
+void ReportCache::checkGeneration() {
+    // the cached reports don't match the data anymore
+    const quint64 generation = _control->dataGeneration();
+    if (generation != _generation) {
+        _generation = generation;
+        clear();
+    }
+}
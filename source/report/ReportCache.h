@@ -0,0 +1,54 @@
+#ifndef TOM_UI_REPORTCACHE_H
+#define TOM_UI_REPORTCACHE_H
+
+#include <QtCore/QCache>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QTemporaryDir>
+
+#include "gotime/TomControl.h"
+#include "gotime/ReportOptions.h"
+
+/**
+ * Cache of generated HTML reports.
+ * The reports are stored by a hash of their options and of the data generation of TomControl, all reports are
+ * dropped when the data was modified. The reports are kept in memory and, optionally, in a temporary directory
+ * which keeps the reports which were evicted from memory.
+ */
+class ReportCache : public QObject {
+Q_OBJECT
+
+public:
+    ReportCache(TomControl *control, bool diskCache, QObject *parent);
+
+    /**
+     * @return true if a report for the options was found, the HTML is stored in html then.
+     */
+    bool lookup(const ReportOptions &options, QString &html);
+
+    /**
+     * Stores a report which was generated from the data of the given generation.
+     * The report is dropped if the data was modified since then.
+     */
+    void insert(const ReportOptions &options, quint64 generation, const QString &html);
+
+    void remove(const ReportOptions &options);
+
+    void clear();
+
+private:
+    QByteArray key(const ReportOptions &options) const;
+
+    QString diskPath(const QByteArray &key) const;
+
+    void checkGeneration();
+
+    TomControl *_control;
+    quint64 _generation;
+
+    // the cost of an entry is its size in KiB
+    QCache<QByteArray, QString> _memory;
+    QScopedPointer<QTemporaryDir> _diskDir;
+};
+
+#endif //TOM_UI_REPORTCACHE_H
@@ -0,0 +1,353 @@
+#include <algorithm>
+
+#include <QtCore/QFile>
+#include <QtCore/QLocale>
+
+#include "ReportEngine.h"
+
+ReportEngine::ReportEngine(TomControl *control, const ReportOptions &options) : _control(control),
+                                                                               _options(options),
+                                                                               _keepEntries(options.templateID == "timelog") {
+    for (const auto &project : control->cachedProjects()) {
+        _projectNames.insert(project.getID(), project.getName());
+        if (options.showSales) {
+            _hourlyRates.insert(project.getID(), control->appliedHourlyRate(project.getID()));
+        }
+    }
+
+    _nodes.append(Node());
+    _nodes[0].title = options.title.isEmpty() ? tr("Report") : options.title;
+
+    if (_options.showEmpty) {
+        addEmptyProjects();
+    }
+}
+
+bool ReportEngine::loadFrames() {
+    // the same frame is loaded more than once if the projects are nested
+    QSet<QString> added;
+    const QStringList &projectIDs = _options.projectIDs.isEmpty() ? QStringList() << "" : _options.projectIDs;
+    for (const auto &projectID : projectIDs) {
+        const bool includeSubprojects = _options.includeSubprojects || projectID.isEmpty();
+        const bool ok = _control->streamFrames(projectID, includeSubprojects, _options.includeArchived, [this, &added](Frame &frame) {
+            if (!added.contains(frame.id)) {
+                added << frame.id;
+                addFrame(&frame);
+            }
+            return true;
+        });
+
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReportEngine::loadRollup(const RollupCube *cube) {
+    if (_keepEntries || !cube || !cube->canAnswer(_options)) {
+        return false;
+    }
+
+    cube->forEachCell(_options, [this](const QString &projectID, const QDate &day, qint64 millis, qint64 exactMillis) {
+        // the totals of a day are added like a single frame, all splits only depend on the project and the day
+        Entry entry;
+        entry.start = QDateTime(day, QTime(0, 0)).toMSecsSinceEpoch();
+        entry.stop = entry.start;
+        entry.millis = millis;
+        entry.exactMillis = exactMillis;
+        entry.projectID = projectID;
+        addEntry(entry);
+    });
+    return true;
+}
+
+void ReportEngine::addFrame(Frame *frame) {
+    if (!frame->startTime.isValid() || (frame->archived && !_options.includeArchived)) {
+        return;
+    }
+
+    const QDate &day = frame->startTime.date();
+    if ((_options.start.isValid() && day < _options.start) || (_options.end.isValid() && day > _options.end)) {
+        return;
+    }
+
+    Entry entry;
+    entry.start = frame->startTime.toMSecsSinceEpoch();
+    entry.exactMillis = frame->durationMillis(true);
+    entry.stop = entry.start + entry.exactMillis;
+    entry.millis = rounded(entry.exactMillis);
+    entry.projectID = frame->projectID;
+    if (_keepEntries) {
+        entry.notes = frame->notes;
+    }
+    addEntry(entry);
+}
+
+void ReportEngine::addEntry(const Entry &entry) {
+    const double sales = _options.showSales ? hourlyRate(entry.projectID) * entry.millis / (60.0 * 60.0 * 1000.0) : 0;
+
+    int entryIndex = -1;
+    if (_keepEntries) {
+        entryIndex = _entries.size();
+        _entries.append(entry);
+    }
+
+    // the totals are added to all nodes on the path to the leaf of the frame
+    int node = 0;
+    addToNode(node, entry, -1, sales);
+    for (int i = 0; i < _options.splits.size(); i++) {
+        QString key;
+        QString title;
+        splitKey(_options.splits.at(i), entry, key, title);
+
+        node = childNode(node, key, title);
+        addToNode(node, entry, i == _options.splits.size() - 1 ? entryIndex : -1, sales);
+    }
+
+    if (_options.splits.isEmpty() && entryIndex >= 0) {
+        _nodes[0].entries.append(entryIndex);
+    }
+}
+
+void ReportEngine::writeHtml(QIODevice *device) {
+    QString css = this->css();
+    if (!_options.cssFile.isEmpty()) {
+        QFile cssFile(_options.cssFile);
+        if (cssFile.open(QIODevice::ReadOnly)) {
+            css = QString::fromUtf8(cssFile.readAll());
+        }
+    }
+
+    HtmlWriter html(device);
+    html.startDocument(_nodes[0].title, css);
+    html.element("h1", _nodes[0].title);
+    if (!_options.description.isEmpty()) {
+        html.element("p", _options.description, "description");
+    }
+
+    if (_options.showSummary) {
+        html.startElement("div", "summary");
+        html.element("h2", tr("Summary"));
+        writeTotals(html, _nodes[0]);
+        html.endElement();
+    }
+
+    const Node &root = _nodes.at(0);
+    for (int child : root.children) {
+        writeNode(html, child, 2);
+    }
+    if (root.children.isEmpty()) {
+        if (!_options.showSummary) {
+            writeTotals(html, root);
+        }
+        writeEntries(html, root);
+    }
+
+    html.endDocument();
+}
+
+qint64 ReportEngine::totalMillis(bool exact) const {
+    return exact ? _nodes.at(0).exactMillis : _nodes.at(0).millis;
+}
+
+int ReportEngine::childNode(int parent, const QString &key, const QString &title) {
+    auto existing = _nodes[parent].children.constFind(key);
+    if (existing != _nodes[parent].children.constEnd()) {
+        return existing.value();
+    }
+
+    Node node;
+    node.title = title;
+    _nodes.append(node);
+
+    const int index = _nodes.size() - 1;
+    _nodes[parent].children.insert(key, index);
+    return index;
+}
+
+void ReportEngine::addToNode(int nodeIndex, const Entry &entry, int entryIndex, double sales) {
+    Node &node = _nodes[nodeIndex];
+    node.millis += entry.millis;
+    node.exactMillis += entry.exactMillis;
+    node.sales += sales;
+
+    const QDate &day = QDateTime::fromMSecsSinceEpoch(entry.start).date();
+    node.days.insert(day);
+    if (!node.firstDay.isValid() || day < node.firstDay) {
+        node.firstDay = day;
+    }
+    if (!node.lastDay.isValid() || day > node.lastDay) {
+        node.lastDay = day;
+    }
+
+    if (entryIndex >= 0) {
+        node.entries.append(entryIndex);
+    }
+}
+
+void ReportEngine::splitKey(const QString &split, const Entry &entry, QString &key, QString &title) const {
+    const QDate &day = QDateTime::fromMSecsSinceEpoch(entry.start).date();
+    const QLocale locale;
+
+    if (split == "project") {
+        const QString &name = projectName(entry.projectID);
+        key = name.toLower() + '\n' + entry.projectID;
+        title = name.isEmpty() ? tr("No project") : name;
+    } else if (split == "year") {
+        key = QString::number(day.year());
+        title = key;
+    } else if (split == "month") {
+        key = day.toString("yyyy-MM");
+        title = locale.toString(day, "MMMM yyyy");
+    } else if (split == "week") {
+        int year = 0;
+        const int week = day.weekNumber(&year);
+        key = QString("%1-%2").arg(year).arg(week, 2, 10, QChar('0'));
+        title = tr("Week %1, %2").arg(week).arg(year);
+    } else if (split == "day") {
+        key = day.toString(Qt::ISODate);
+        title = locale.toString(day, QLocale::LongFormat);
+    } else {
+        key.clear();
+        title = split;
+    }
+}
+
+void ReportEngine::addEmptyProjects() {
+    // empty projects are only listed on the first level
+    if (_options.splits.isEmpty() || _options.splits.first() != "project") {
+        return;
+    }
+
+    QStringList ids;
+    if (_options.projectIDs.isEmpty()) {
+        for (const auto &project : _control->cachedProjects()) {
+            ids << project.getID();
+        }
+    } else {
+        for (const auto &id : _options.projectIDs) {
+            ids << _control->projectIDs(id, _options.includeSubprojects);
+        }
+    }
+
+    for (const auto &id : ids) {
+        const QString &name = projectName(id);
+        childNode(0, name.toLower() + '\n' + id, name);
+    }
+}
+
+qint64 ReportEngine::rounded(qint64 millis) const {
+    return roundedMillis(millis, _options.frameRoundingMode, _options.frameRoundingMinutes);
+}
+
+QString ReportEngine::projectName(const QString &projectID) const {
+    return _projectNames.value(projectID);
+}
+
+double ReportEngine::hourlyRate(const QString &projectID) const {
+    return _hourlyRates.value(projectID);
+}
+
+void ReportEngine::writeNode(HtmlWriter &html, int nodeIndex, int depth) {
+    static const char *headings[] = {"h1", "h2", "h3", "h4", "h5", "h6"};
+
+    const Node &node = _nodes.at(nodeIndex);
+    html.startElement("section", QString("split-%1").arg(depth - 1));
+    html.element(headings[qMin(depth, 6) - 1], node.title);
+    writeTotals(html, node);
+
+    for (int child : node.children) {
+        writeNode(html, child, depth + 1);
+    }
+    writeEntries(html, node);
+
+    html.endElement();
+}
+
+void ReportEngine::writeTotals(HtmlWriter &html, const Node &node) {
+    auto row = [&html](const QString &label, const QString &value) {
+        html.startElement("tr");
+        html.element("th", label);
+        html.element("td", value);
+        html.endElement();
+    };
+
+    html.startElement("table", "totals");
+    row(tr("Duration"), formatDuration(node.millis));
+    if (_options.frameRoundingMode != NONE) {
+        row(tr("Exact duration"), formatDuration(node.exactMillis));
+    }
+    if (_options.showTracked) {
+        row(tr("Tracked average per day"), formatDuration(node.days.isEmpty() ? 0 : node.millis / node.days.size()));
+    }
+    if (_options.showUntracked) {
+        // the untracked average includes the days without time entries
+        QDate first = node.firstDay;
+        QDate last = node.lastDay;
+        if (&node == &_nodes.at(0) && _options.start.isValid() && _options.end.isValid()) {
+            first = _options.start;
+            last = _options.end;
+        }
+        const qint64 days = first.isValid() ? first.daysTo(last) + 1 : 0;
+        row(tr("Untracked average per day"), formatDuration(days > 0 ? node.millis / days : 0));
+    }
+    if (_options.showSales) {
+        row(tr("Sales"), QLocale().toString(node.sales, 'f', 2));
+    }
+    html.endElement();
+}
+
+void ReportEngine::writeEntries(HtmlWriter &html, const Node &node) {
+    if (!_keepEntries || node.entries.isEmpty()) {
+        return;
+    }
+
+    QVector<int> entries = node.entries;
+    std::sort(entries.begin(), entries.end(), [this](int a, int b) {
+        return _entries[a].start < _entries[b].start;
+    });
+
+    const QLocale locale;
+    html.startElement("table", "entries");
+    html.startElement("tr");
+    html.element("th", tr("Date"));
+    html.element("th", tr("Start"));
+    html.element("th", tr("End"));
+    html.element("th", tr("Duration"));
+    html.element("th", tr("Project"));
+    html.element("th", tr("Notes"));
+    html.endElement();
+
+    for (int index : entries) {
+        const Entry &entry = _entries[index];
+        const QDateTime &start = QDateTime::fromMSecsSinceEpoch(entry.start);
+        const QDateTime &stop = QDateTime::fromMSecsSinceEpoch(entry.stop);
+
+        html.startElement("tr");
+        html.element("td", locale.toString(start.date(), QLocale::ShortFormat));
+        html.element("td", locale.toString(start.time(), QLocale::ShortFormat));
+        html.element("td", locale.toString(stop.time(), QLocale::ShortFormat));
+        html.element("td", formatDuration(entry.millis), "duration");
+        html.element("td", projectName(entry.projectID));
+        html.element("td", entry.notes);
+        html.endElement();
+    }
+    html.endElement();
+}
+
+QString ReportEngine::formatDuration(qint64 millis) const {
+    const Timespan span(millis);
+    return _options.decimalTimeFormat ? span.formatDecimal() : span.formatShort();
+}
+
+QString ReportEngine::css() const {
+    return "body { font-family: sans-serif; font-size: 10pt; margin: 1em; }\n"
+           "h1, h2, h3, h4, h5, h6 { margin: 0.8em 0 0.3em 0; }\n"
+           "section { margin-left: 1em; }\n"
+           "table { border-collapse: collapse; margin-bottom: 0.5em; }\n"
+           "th, td { padding: 2px 8px; text-align: left; }\n"
+           "table.totals td, td.duration { text-align: right; font-family: monospace; }\n"
+           "table.entries tr:nth-child(even) { background-color: #f2f2f2; }\n"
+           ".description { color: #555; }";
+}
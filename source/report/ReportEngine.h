@@ -0,0 +1,115 @@
+#ifndef TOM_UI_REPORTENGINE_H
+#define TOM_UI_REPORTENGINE_H
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QIODevice>
+#include <QtCore/QMap>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+
+#include "gotime/TomControl.h"
+#include "gotime/ReportOptions.h"
+#include "gotime/RollupCube.h"
+#include "HtmlWriter.h"
+
+/**
+ * Generates HTML reports in the application, without tom's report command.
+ * The frames are rounded one by one and grouped by the splits in the order of the options. Each group has the
+ * rounded and the exact duration, the sales and the tracked and untracked averages per day.
+ * The "default" template displays the totals of the groups, the "timelog" template adds the time entries.
+ * The names and rates of the projects are copied when the engine is created. The frames can be loaded and the report
+ * can be written in another thread.
+ */
+class ReportEngine {
+Q_DECLARE_TR_FUNCTIONS(ReportEngine)
+
+public:
+    ReportEngine(TomControl *control, const ReportOptions &options);
+
+    /**
+     * Loads the frames of the projects of the options from tom and adds them to the report.
+     * @return false if tom's frames couldn't be read completely.
+     */
+    bool loadFrames();
+
+    /**
+     * Adds the daily totals of the cube instead of the frames. This isn't possible if the time entries are displayed
+     * or if the cube doesn't support the rounding of the options.
+     * @return false if the totals couldn't be added.
+     */
+    bool loadRollup(const RollupCube *cube);
+
+    /**
+     * Adds a frame to the report. Frames outside of the date range and excluded archived frames are skipped.
+     */
+    void addFrame(Frame *frame);
+
+    void writeHtml(QIODevice *device);
+
+    /**
+     * @return The rounded or the exact duration of all added frames.
+     */
+    qint64 totalMillis(bool exact) const;
+
+private:
+    struct Entry {
+        qint64 start;
+        qint64 stop;
+        qint64 millis;
+        qint64 exactMillis;
+        QString projectID;
+        QString notes;
+    };
+
+    struct Node {
+        QString title;
+        qint64 millis = 0;
+        qint64 exactMillis = 0;
+        double sales = 0;
+        QDate firstDay;
+        QDate lastDay;
+        // the days with time entries, for the tracked average
+        QSet<QDate> days;
+        // sort key -> index of the child node
+        QMap<QString, int> children;
+        QVector<int> entries;
+    };
+
+    void addEntry(const Entry &entry);
+
+    int childNode(int parent, const QString &key, const QString &title);
+
+    void addToNode(int node, const Entry &entry, int entryIndex, double sales);
+
+    void splitKey(const QString &split, const Entry &entry, QString &key, QString &title) const;
+
+    void addEmptyProjects();
+
+    qint64 rounded(qint64 millis) const;
+
+    QString projectName(const QString &projectID) const;
+
+    double hourlyRate(const QString &projectID) const;
+
+    void writeNode(HtmlWriter &html, int nodeIndex, int depth);
+
+    void writeTotals(HtmlWriter &html, const Node &node);
+
+    void writeEntries(HtmlWriter &html, const Node &node);
+
+    QString formatDuration(qint64 millis) const;
+
+    QString css() const;
+
+    const TomControl *_control;
+    ReportOptions _options;
+    bool _keepEntries;
+
+    // the root is the first node
+    QVector<Node> _nodes;
+    QVector<Entry> _entries;
+    QHash<QString, QString> _projectNames;
+    QHash<QString, double> _hourlyRates;
+};
+
+#endif //TOM_UI_REPORTENGINE_H
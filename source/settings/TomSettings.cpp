@@ -10,6 +10,17 @@ void TomSettings::setOpenMainWindowAtStartup(bool show) {
     settings.setValue("mainWindow/showAtStartup", show);
 }
 
+int TomSettings::recentProjectsCount() {
+    QSettings settings;
+    return settings.value("recentProjects/count", 5).toInt();
+}
+
+void TomSettings::setRecentProjectsCount(int count) {
+    QSettings settings;
+    settings.setValue("recentProjects/count", count);
+    emit recentProjectsCountChanged(count);
+}
+
 void TomSettings::loadAction(QAction *action) {
     if (!action->objectName().isEmpty()) {
         QSettings settings;
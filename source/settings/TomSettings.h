@@ -13,6 +13,11 @@ public:
 
     bool openMainWindowAtStartup();
 
+    /**
+     * @return The number of recent projects displayed in the menus.
+     */
+    int recentProjectsCount();
+
     void loadAction(QAction *action);
 
     void saveAction(QAction *action);
@@ -20,6 +25,12 @@ public:
 public slots:
 
     void setOpenMainWindowAtStartup(bool show);
+
+    void setRecentProjectsCount(int count);
+
+signals:
+
+    void recentProjectsCountChanged(int count);
 };
 
 
@@ -9,4 +9,8 @@ void ApplicationSettingsPage::setup(TomSettings *settings) {
 
     connect(mainWindowStartup, &QCheckBox::toggled,
             settings, &TomSettings::setOpenMainWindowAtStartup);
+
+    recentProjectsCount->setValue(settings->recentProjectsCount());
+    connect(recentProjectsCount, QOverload<int>::of(&QSpinBox::valueChanged),
+            settings, &TomSettings::setRecentProjectsCount);
 }
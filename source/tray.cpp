@@ -48,6 +48,7 @@ GotimeTrayIcon::GotimeTrayIcon(TomControl *control, MainWindow *mainWindow) : QO
 
     connect(control, &TomControl::projectStatusChanged, this, &GotimeTrayIcon::updateAll);
     connect(control, &TomControl::projectUpdated, this, &GotimeTrayIcon::updateAll);
+    connect(control->recentProjects(), &RecentProjects::changed, this, &GotimeTrayIcon::updateContextMenu);
 
     connect(_trayIcon, &QSystemTrayIcon::activated, [this, mainWindow](QSystemTrayIcon::ActivationReason reason) {
         if (reason == QSystemTrayIcon::DoubleClick || reason == QSystemTrayIcon::MiddleClick) {
@@ -62,10 +63,10 @@ GotimeTrayIcon::GotimeTrayIcon(TomControl *control, MainWindow *mainWindow) : QO
 
     updateAll();
 
-    // update tooltip every 30s
-    auto *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &GotimeTrayIcon::updateIconAndTooltip);
-    timer->start(30000);
+    // update tooltip every 30s, the tooltip is also updated when it's about to be shown
+    control->scheduler()->addTask("tray tooltip", 30 * 1000, RefreshScheduler::BackgroundTask, this, [this] {
+        updateIconAndTooltip();
+    });
 }
 
 void GotimeTrayIcon::updateAll() {
@@ -0,0 +1,105 @@
+#include <QtWidgets/QMenu>
+#include <QtWidgets/QHeaderView>
+
+#include "frameEditor/FrameEditorDialog.h"
+#include "FrameGroupView.h"
+#include "IconItemDelegate.h"
+#include "icons.h"
+
+FrameGroupView::FrameGroupView(QWidget *parent) : QTreeView(parent),
+                                                  _control(nullptr),
+                                                  _statusManager(nullptr),
+                                                  _frameModel(nullptr),
+                                                  _groupModel(nullptr) {
+    setContextMenuPolicy(Qt::CustomContextMenu);
+    setUniformRowHeights(true);
+    setAlternatingRowColors(true);
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
+    setSelectionBehavior(QAbstractItemView::SelectRows);
+    setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
+    setAnimated(false);
+
+    setItemDelegateForColumn(FrameTableViewModel::COL_ARCHIVED, new IconItemDelegate(Icons::timeEntryArchive(), this));
+}
+
+void FrameGroupView::setup(TomControl *control, ProjectStatusManager *statusManager, FrameTableViewModel *frameModel) {
+    _control = control;
+    _statusManager = statusManager;
+    _frameModel = frameModel;
+
+    _groupModel = new FrameGroupModel(frameModel, this);
+    setModel(_groupModel);
+
+    // the group labels are shown in the day column, the tree has to be displayed there, too
+    setTreePosition(FrameTableViewModel::COL_START_DATE);
+
+    header()->setStretchLastSection(true);
+    header()->setSectionResizeMode(FrameTableViewModel::COL_ARCHIVED, QHeaderView::ResizeToContents);
+    header()->setSectionResizeMode(FrameTableViewModel::COL_START_DATE, QHeaderView::ResizeToContents);
+    header()->setSectionResizeMode(FrameTableViewModel::COL_START, QHeaderView::ResizeToContents);
+    header()->setSectionResizeMode(FrameTableViewModel::COL_END, QHeaderView::ResizeToContents);
+    header()->setSectionResizeMode(FrameTableViewModel::COL_DURATION, QHeaderView::ResizeToContents);
+
+    // the hidden columns have to match the default settings
+    hideColumn(FrameTableViewModel::COL_TAGS);
+    hideColumn(FrameTableViewModel::COL_LAST_UPDATED);
+
+    // expand the most recent group after the data was reloaded
+    connect(_groupModel, &QAbstractItemModel::modelReset, this, [this] {
+        expand(_groupModel->index(0, 0, QModelIndex()));
+    });
+
+    connect(this, &FrameGroupView::customContextMenuRequested, this, &FrameGroupView::onCustomContextMenuRequested);
+    connect(frameModel, &FrameTableViewModel::subprojectStatusChange, this, &FrameGroupView::onSubprojectStatusChange);
+}
+
+QList<Frame *> FrameGroupView::selectedFrames() const {
+    QList<Frame *> frames;
+    for (const auto &row : selectionModel()->selectedRows(FrameTableViewModel::FIRST_COL)) {
+        if (Frame *frame = _groupModel->frameAt(row)) {
+            frames << frame;
+        }
+    }
+    return frames;
+}
+
+Frame *FrameGroupView::frameAt(const QModelIndex &viewIndex) const {
+    return _groupModel->frameAt(viewIndex);
+}
+
+void FrameGroupView::setGrouping(FrameGroupModel::Grouping grouping) {
+    _groupModel->setGrouping(grouping);
+}
+
+void FrameGroupView::setShowArchived(bool showArchived) {
+    setColumnHidden(FrameTableViewModel::COL_ARCHIVED, !showArchived);
+}
+
+void FrameGroupView::setShowLastUpdatedColumn(bool showUpdated) {
+    setColumnHidden(FrameTableViewModel::COL_LAST_UPDATED, !showUpdated);
+}
+
+void FrameGroupView::onSubprojectStatusChange(bool available) {
+    setColumnHidden(FrameTableViewModel::COL_SUBPROJECT, !available);
+}
+
+void FrameGroupView::onCustomContextMenuRequested(const QPoint &pos) {
+    Frame *frame = _groupModel->frameAt(indexAt(pos));
+    if (!frame) {
+        return;
+    }
+
+    const QList<Frame *> &selected = selectedFrames();
+
+    QMenu menu;
+    auto *stop = menu.addAction(Icons::stopTimer(), tr("Stop time entry"), [this] { _control->stopActivity(); });
+    stop->setEnabled(frame->isActive());
+    menu.addSeparator();
+    auto *editAction = menu.addAction(Icons::frameEdit(), tr("Edit time entry..."), [this, frame] { FrameEditorDialog::show(*frame, _control, _statusManager, &_frameModel->intervalIndex(), this); });
+    editAction->setEnabled(selected.size() == 1);
+    menu.addSeparator();
+    menu.addAction(Icons::timeEntryArchive(), tr("Archive selected entries"), [this, selected] {
+        _control->updateFrame(selected, false, QDateTime(), false, QDateTime(), false, "", false, "", true, true);
+    });
+    menu.exec(viewport()->mapToGlobal(pos));
+}
@@ -0,0 +1,47 @@
+#ifndef TOM_UI_FRAMEGROUPVIEW_H
+#define TOM_UI_FRAMEGROUPVIEW_H
+
+#include <QtWidgets/QTreeView>
+
+#include "gotime/TomControl.h"
+#include "gotime/ProjectStatusManager.h"
+#include "model/FrameTableViewModel.h"
+#include "model/FrameGroupModel.h"
+
+/**
+ * Displays the time entries of FrameTableViewModel grouped by day or by week.
+ */
+class FrameGroupView : public QTreeView {
+Q_OBJECT
+
+public:
+    explicit FrameGroupView(QWidget *parent);
+
+    void setup(TomControl *control, ProjectStatusManager *statusManager, FrameTableViewModel *frameModel);
+
+    QList<Frame *> selectedFrames() const;
+
+    Frame *frameAt(const QModelIndex &viewIndex) const;
+
+public slots:
+
+    void setGrouping(FrameGroupModel::Grouping grouping);
+
+    void setShowArchived(bool showArchived);
+
+    void setShowLastUpdatedColumn(bool showUpdated);
+
+private slots:
+
+    void onCustomContextMenuRequested(const QPoint &pos);
+
+    void onSubprojectStatusChange(bool available);
+
+private:
+    TomControl *_control;
+    ProjectStatusManager *_statusManager;
+    FrameTableViewModel *_frameModel;
+    FrameGroupModel *_groupModel;
+};
+
+#endif //TOM_UI_FRAMEGROUPVIEW_H
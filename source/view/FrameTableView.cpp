@@ -1,6 +1,7 @@
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QLabel>
+#include <QtWidgets/QMessageBox>
 #include <QDrag>
 #include <QPixmap>
 #include <QPainter>
@@ -83,14 +84,34 @@ void FrameTableView::showContextMenu(Frame *frame, QPoint globalPos) {
     auto *stop = menu.addAction(Icons::stopTimer(), tr("Stop time entry"), [this] { _control->stopActivity(); });
     stop->setEnabled(frame->isActive());
     menu.addSeparator();
-    auto *editAction = menu.addAction(Icons::frameEdit(), tr("Edit time entry..."), [this, frame] { FrameEditorDialog::show(*frame, _control, _statusManager, this); });
+    auto *editAction = menu.addAction(Icons::frameEdit(), tr("Edit time entry..."), [this, frame] { FrameEditorDialog::show(*frame, _control, _statusManager, &_sourceModel->intervalIndex(), this); });
     editAction->setEnabled(selectedCount == 1);
     menu.addAction(_deleteSelectedAction);
     menu.addSeparator();
     menu.addAction(Icons::timeEntryArchive(), tr("Archive selected entries"), this, &FrameTableView::archiveSelectedEntries);
+    menu.addSeparator();
+    const QDate &day = frame->startTime.date();
+    menu.addAction(tr("Show gaps of %1...").arg(day.toString(Qt::SystemLocaleShortDate)), [this, day] { showGaps(day); });
     menu.exec(globalPos);
 }
 
+void FrameTableView::showGaps(const QDate &day) {
+    QStringList lines;
+    for (const auto &gap : _sourceModel->intervalIndex().gaps(day)) {
+        lines << tr("%1 - %2 (%3)")
+                .arg(gap.first.time().toString(Qt::SystemLocaleShortDate))
+                .arg(gap.second.time().toString(Qt::SystemLocaleShortDate))
+                .arg(Timespan::of(gap.first, gap.second).format());
+    }
+
+    const QString &title = tr("Gaps of %1").arg(day.toString(Qt::SystemLocaleLongDate));
+    if (lines.isEmpty()) {
+        QMessageBox::information(this, title, tr("There are no untracked gaps between the time entries of this day."));
+    } else {
+        QMessageBox::information(this, title, lines.join("\n"));
+    }
+}
+
 void FrameTableView::onProjectSelected(const Project &project) {
     _sourceModel->loadFrames(project);
 }
@@ -194,6 +215,14 @@ QList<Frame *> FrameTableView::selectedFrames() const {
     return frames;
 }
 
+Frame *FrameTableView::frameAt(const QModelIndex &viewIndex) const {
+    return _sourceModel->frameAt(_proxyModel->mapToSource(viewIndex));
+}
+
+FrameTableViewModel *FrameTableView::frameModel() const {
+    return _sourceModel;
+}
+
 void FrameTableView::startDrag(Qt::DropActions supportedActions) {
     QModelIndexList indexes = selectedIndexes();
     if (indexes.count() > 0) {
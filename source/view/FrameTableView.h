@@ -23,6 +23,10 @@ public:
 
     QList<Frame *> selectedFrames() const;
 
+    Frame *frameAt(const QModelIndex &viewIndex) const;
+
+    FrameTableViewModel *frameModel() const;
+
     void readSettings();
 
     void writeSettings();
@@ -60,6 +64,8 @@ private:
 
     void showContextMenu(Frame *frame, QPoint globalPos);
 
+    void showGaps(const QDate &day);
+
     QAction *_deleteSelectedAction;
 };
 
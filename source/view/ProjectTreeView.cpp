@@ -2,7 +2,6 @@
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QHeaderView>
 
-#include "model/ProjectTreeSortFilterModel.h"
 #include "model/UserRoles.h"
 #include "projectEditor/ProjectEditorDialog.h"
 #include "dialogs/CommonDialogs.h"
@@ -41,7 +40,8 @@ void ProjectTreeView::setup(TomControl *control, ProjectStatusManager *statusMan
 
     setModel(_proxyModel);
 
-    _sourceModel->loadProjects();
+    // the projects were loaded at startup
+    _sourceModel->loadCachedProjects();
 
     // new QAbstractItemModelTester(_proxyModel, QAbstractItemModelTester::FailureReportingMode::Fatal, this);
 
@@ -52,6 +52,12 @@ void ProjectTreeView::setup(TomControl *control, ProjectStatusManager *statusMan
     connect(selectionModel(), &QItemSelectionModel::currentRowChanged, this, &ProjectTreeView::onCurrentChanged);
     connect(_control, &TomControl::projectUpdated, this, &ProjectTreeView::projectUpdated);
     connect(_statusManager, &ProjectStatusManager::projectsStatusChanged, this, &ProjectTreeView::projectsStatusChanged);
+
+    connect(_control, &TomControl::projectCreated, this, &ProjectTreeView::onProjectsChanged);
+    connect(_control, &TomControl::projectUpdated, this, &ProjectTreeView::onProjectsChanged);
+    connect(_control, &TomControl::projectRemoved, this, &ProjectTreeView::onProjectsChanged);
+    connect(_control, &TomControl::projectHierarchyChanged, this, &ProjectTreeView::onProjectsChanged);
+    connect(_control, &TomControl::dataResetNeeded, this, &ProjectTreeView::onProjectsChanged);
 }
 
 void ProjectTreeView::onCurrentChanged(const QModelIndex &index, const QModelIndex &) {
@@ -97,9 +103,56 @@ void ProjectTreeView::showContextMenu(ProjectTreeItem *item, const QPoint &globa
 void ProjectTreeView::refresh() {
     reset();
     _proxyModel->invalidate();
-    _sourceModel->loadProjects();
+    // the projects were just reloaded by TomControl::resetCache()
+    _sourceModel->loadCachedProjects();
 
     expandToDepth(0);
+    onProjectsChanged();
+}
+
+void ProjectTreeView::setFilterText(const QString &text) {
+    const QString &query = text.trimmed();
+    if (query.isEmpty()) {
+        _filterText.clear();
+        _filterMatches.clear();
+        if (_proxyModel->isFiltered()) {
+            _proxyModel->clearAcceptedProjectIDs();
+            collapseAll();
+            expandToDepth(0);
+            scrollTo(currentIndex(), PositionAtCenter);
+        }
+        return;
+    }
+
+    if (_nameIndexDirty) {
+        _nameIndex.reset(_control->cachedProjects());
+        _nameIndexDirty = false;
+        // the previous matches may be outdated
+        _filterText.clear();
+    }
+
+    // a longer query only has to check the previous matches
+    if (!_filterText.isEmpty() && query.contains(_filterText, Qt::CaseInsensitive)) {
+        _filterMatches = _nameIndex.refine(_filterMatches, query);
+    } else {
+        _filterMatches = _nameIndex.match(query);
+    }
+    _filterText = query;
+
+    // the proxy only sees the items which were already created by the lazy source model
+    for (const auto &id : _filterMatches) {
+        _sourceModel->getProjectRow(id);
+    }
+
+    _proxyModel->setAcceptedProjectIDs(_nameIndex.withAncestors(_filterMatches));
+    expandAll();
+}
+
+void ProjectTreeView::onProjectsChanged() {
+    _nameIndexDirty = true;
+    if (_proxyModel && _proxyModel->isFiltered()) {
+        setFilterText(_filterText);
+    }
 }
 
 void ProjectTreeView::projectUpdated(const Project &project) {
@@ -107,9 +160,7 @@ void ProjectTreeView::projectUpdated(const Project &project) {
 }
 
 void ProjectTreeView::projectsStatusChanged(const QStringList &projectIDs) {
-    for (const auto &id : projectIDs) {
-        _sourceModel->updateProjectStatus(id);
-    }
+    _sourceModel->updateProjectStatus(projectIDs);
 }
 
 void ProjectTreeView::createNewProject(const Project &parentProject) {
@@ -6,6 +6,8 @@
 
 #include "model/ProjectTreeItem.h"
 #include "model/ProjectTreeModel.h"
+#include "model/ProjectNameIndex.h"
+#include "model/ProjectTreeSortFilterModel.h"
 #include "gotime/TomControl.h"
 
 class ProjectTreeView : public QTreeView {
@@ -54,6 +56,11 @@ public slots:
 
     void setShowArchived(bool showArchived);
 
+    /**
+     * Only displays the projects with a name containing the text and their parent projects.
+     */
+    void setFilterText(const QString &text);
+
 private slots:
 
     void onCustomContextMenuRequested(const QPoint &pos);
@@ -66,6 +73,8 @@ private slots:
 
     void deleteSelectedProject();
 
+    void onProjectsChanged();
+
 private:
     void createNewProject(const Project &parentProject);
 
@@ -80,9 +89,15 @@ private:
     ProjectStatusManager *_statusManager{};
 
     ProjectTreeModel *_sourceModel{};
-    QSortFilterProxyModel *_proxyModel{};
+    ProjectTreeSortFilterModel *_proxyModel{};
 
     QAction *_deleteSelectedAction;
+
+    ProjectNameIndex _nameIndex;
+    bool _nameIndexDirty = true;
+    // the current filter and its matches, without the parent projects
+    QString _filterText;
+    QSet<QString> _filterMatches;
 };
 
 
@@ -0,0 +1,143 @@
+#include <QtTest/QtTest>
+
+#include "model/FrameIntervalIndex.h"
+
+/**
+ * Compares the overlap queries of the index with a scan of all frames while frames are inserted, modified and removed.
+ */
+class FrameIntervalIndexTest : public QObject {
+Q_OBJECT
+
+private slots:
+
+    void cleanup() {
+        qDeleteAll(_frames);
+        _frames.clear();
+    }
+
+    void emptyIndex() {
+        FrameIntervalIndex index;
+        QVERIFY(index.overlapping(QDateTime::currentDateTime(), QDateTime()).isEmpty());
+        QVERIFY(index.gaps(QDate::currentDate()).isEmpty());
+    }
+
+    void overlapping() {
+        Frame *first = addFrame(8 * 60, 9 * 60);
+        Frame *second = addFrame(8 * 60 + 30, 10 * 60);
+        Frame *third = addFrame(10 * 60, 11 * 60);
+
+        FrameIntervalIndex index;
+        index.reset(_frames);
+
+        QVERIFY(index.hasOverlap(first));
+        QVERIFY(index.hasOverlap(second));
+        // adjacent frames don't overlap
+        QVERIFY(!index.hasOverlap(third));
+
+        third->startTime = third->startTime.addSecs(-60);
+        index.update(third);
+        QVERIFY(index.hasOverlap(third));
+        QCOMPARE(index.overlapping(third), QList<Frame *>() << second);
+
+        index.remove(second);
+        QVERIFY(!index.hasOverlap(first));
+        QVERIFY(!index.hasOverlap(third));
+    }
+
+    void gaps() {
+        addFrame(8 * 60, 9 * 60);
+        addFrame(8 * 60 + 30, 10 * 60);
+        addFrame(11 * 60, 12 * 60);
+
+        FrameIntervalIndex index;
+        index.reset(_frames);
+
+        const QList<FrameIntervalIndex::Gap> &gaps = index.gaps(DAY);
+        QCOMPARE(gaps.size(), 1);
+        QCOMPARE(gaps.first().first, time(10 * 60));
+        QCOMPARE(gaps.first().second, time(11 * 60));
+    }
+
+    void randomEdits() {
+        qsrand(42);
+        FrameIntervalIndex index;
+        for (int i = 0; i < 500; i++) {
+            addRandomFrame();
+        }
+        index.reset(_frames);
+        verify(index);
+
+        QList<Frame *> removed;
+        for (int i = 0; i < 2000; i++) {
+            const int action = qrand() % 3;
+            if (action == 0) {
+                Frame *frame = addRandomFrame();
+                index.insert(frame);
+            } else if (action == 1 && !_frames.isEmpty()) {
+                Frame *frame = _frames.takeAt(qrand() % _frames.size());
+                index.remove(frame);
+                removed << frame;
+            } else if (!_frames.isEmpty()) {
+                Frame *frame = _frames.at(qrand() % _frames.size());
+                frame->startTime = time(qrand() % (24 * 60));
+                frame->stopTime = qrand() % 20 == 0 ? QDateTime() : frame->startTime.addSecs(60 * (1 + qrand() % 120));
+                index.update(frame);
+            }
+
+            if (i % 100 == 0) {
+                verify(index);
+            }
+        }
+        verify(index);
+        qDeleteAll(removed);
+    }
+
+private:
+    const QDate DAY = QDate(2019, 3, 1);
+
+    QDateTime time(int minutes) const {
+        return QDateTime(DAY, QTime(0, 0)).addSecs(minutes * 60);
+    }
+
+    Frame *addFrame(int startMinutes, int stopMinutes) {
+        const QDateTime &stop = stopMinutes < 0 ? QDateTime() : time(stopMinutes);
+        auto *frame = new Frame(QString::number(_frames.size()), "project", time(startMinutes), stop, QDateTime(), "", QStringList(), false);
+        _frames << frame;
+        return frame;
+    }
+
+    Frame *addRandomFrame() {
+        const int start = qrand() % (24 * 60);
+        return addFrame(start, qrand() % 50 == 0 ? -1 : start + 1 + qrand() % 120);
+    }
+
+    void verify(const FrameIntervalIndex &index) const {
+        for (int i = 0; i < 50; i++) {
+            const QDateTime &start = time(qrand() % (24 * 60));
+            const QDateTime &end = start.addSecs(60 * (1 + qrand() % 180));
+
+            QSet<Frame *> expected;
+            for (auto *frame : _frames) {
+                const bool endsAfterStart = frame->isActive() || frame->stopTime > start;
+                if (frame->startTime < end && endsAfterStart) {
+                    expected << frame;
+                }
+            }
+
+            const QList<Frame *> &actual = index.overlapping(start, end);
+            QCOMPARE(actual.toSet(), expected);
+            QCOMPARE(actual.size(), expected.size());
+
+            // the results are ordered by start time
+            for (int j = 1; j < actual.size(); j++) {
+                QVERIFY(actual.at(j - 1)->startTime <= actual.at(j)->startTime);
+            }
+        }
+    }
+
+    QList<Frame *> _frames;
+};
+
+QTEST_MAIN(FrameIntervalIndexTest)
+
+#include "FrameIntervalIndexTest.moc"
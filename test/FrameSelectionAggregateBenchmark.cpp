@@ -0,0 +1,119 @@
+#include <QtCore/QItemSelectionModel>
+#include <QtGui/QStandardItemModel>
+#include <QtTest/QtTest>
+
+#include "model/FrameSelectionAggregate.h"
+
+/**
+ * Compares the update of the selection totals with the deltas of the selection model to the summation over all
+ * selected frames, which was done for each change of the selection before.
+ */
+class FrameSelectionAggregateBenchmark : public QObject {
+Q_OBJECT
+
+private slots:
+
+    void initTestCase() {
+        _control = new TomControl("", false, this);
+    }
+
+    void cleanupTestCase() {
+        qDeleteAll(_frames);
+    }
+
+    void selectAll_data() {
+        rowCounts();
+    }
+
+    void selectAll() {
+        QFETCH(int, rows);
+        QStandardItemModel model(rows, 1);
+        QItemSelectionModel selection(&model);
+        FrameSelectionAggregate aggregate(_control, &selection, resolver(rows), nullptr);
+
+        const QItemSelection all(model.index(0, 0), model.index(rows - 1, 0));
+        QBENCHMARK {
+            selection.select(all, QItemSelectionModel::ClearAndSelect);
+            selection.clearSelection();
+        }
+        QCOMPARE(aggregate.count(), 0);
+    }
+
+    void extendSelection_data() {
+        rowCounts();
+    }
+
+    void extendSelection() {
+        QFETCH(int, rows);
+        QStandardItemModel model(rows, 1);
+        QItemSelectionModel selection(&model);
+        FrameSelectionAggregate aggregate(_control, &selection, resolver(rows), nullptr);
+        selection.select(QItemSelection(model.index(0, 0), model.index(rows - 2, 0)), QItemSelectionModel::Select);
+
+        const QModelIndex &last = model.index(rows - 1, 0);
+        QBENCHMARK {
+            selection.select(last, QItemSelectionModel::Select);
+            aggregate.totalMillis();
+            selection.select(last, QItemSelectionModel::Deselect);
+            aggregate.totalMillis();
+        }
+        QCOMPARE(aggregate.count(), rows - 1);
+    }
+
+    void extendSelectionBySummation_data() {
+        rowCounts();
+    }
+
+    void extendSelectionBySummation() {
+        QFETCH(int, rows);
+        QStandardItemModel model(rows, 1);
+        QItemSelectionModel selection(&model);
+        selection.select(QItemSelection(model.index(0, 0), model.index(rows - 2, 0)), QItemSelectionModel::Select);
+
+        const QModelIndex &last = model.index(rows - 1, 0);
+        qint64 total = 0;
+        QBENCHMARK {
+            selection.select(last, QItemSelectionModel::Select);
+            total = sumSelected(selection);
+            selection.select(last, QItemSelectionModel::Deselect);
+            total = sumSelected(selection);
+        }
+        QVERIFY(total > 0);
+    }
+
+private:
+    void rowCounts() {
+        QTest::addColumn<int>("rows");
+        QTest::newRow("1k") << 1000;
+        QTest::newRow("10k") << 10000;
+        QTest::newRow("100k") << 100000;
+    }
+
+    FrameSelectionAggregate::FrameResolver resolver(int rows) {
+        const QDateTime &start = QDateTime::currentDateTime().addYears(-1);
+        while (_frames.size() < rows) {
+            const QDateTime &frameStart = start.addSecs(_frames.size() * 60);
+            _frames << new Frame(QString::number(_frames.size()), "project", frameStart, frameStart.addSecs(30 + _frames.size() % 600),
+                                 frameStart, "", QStringList(), false);
+        }
+
+        return [this](const QModelIndex &index) {
+            return _frames.value(index.row());
+        };
+    }
+
+    qint64 sumSelected(const QItemSelectionModel &selection) {
+        qint64 total = 0;
+        for (const auto &index : selection.selectedRows()) {
+            total += _frames.at(index.row())->durationMillis(true);
+        }
+        return total;
+    }
+
+    TomControl *_control = nullptr;
+    QList<Frame *> _frames;
+};
+
+QTEST_MAIN(FrameSelectionAggregateBenchmark)
+
+#include "FrameSelectionAggregateBenchmark.moc"
@@ -0,0 +1,152 @@
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "gotime/TomOutputParser.h"
+#include "report/FrameExporter.h"
+
+// tom writes its output in chunks of this size into the pipe
+static const int CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Measures the throughput of streaming frames and of the export. The frames are parsed from memory and read from a
+ * script which prints tom's output, the number of frames per second is the row's frame count divided by the time.
+ */
+class FrameStreamBenchmark : public QObject {
+Q_OBJECT
+
+private slots:
+
+    void initTestCase() {
+#ifdef Q_OS_WIN
+        QSKIP("the frames are printed by a shell script");
+#endif
+        QVERIFY(_dir.isValid());
+    }
+
+    void parseChunks_data() {
+        frameCounts();
+    }
+
+    void parseChunks() {
+        QFETCH(int, frames);
+        const QByteArray &json = generateFrames(frames);
+
+        int count = 0;
+        QBENCHMARK {
+            count = 0;
+            FrameStreamParser parser;
+            for (int offset = 0; offset < json.size(); offset += CHUNK_SIZE) {
+                parser.feed(json.mid(offset, CHUNK_SIZE), [&count](Frame &) {
+                    count++;
+                    return true;
+                });
+            }
+            QVERIFY(parser.isFinished());
+        }
+        QCOMPARE(count, frames);
+    }
+
+    void stream_data() {
+        frameCounts();
+    }
+
+    void stream() {
+        QFETCH(int, frames);
+        TomControl control(fakeTom(frames), false, nullptr);
+
+        int count = 0;
+        QBENCHMARK {
+            count = 0;
+            QVERIFY(control.streamFrames("", true, true, [&count](Frame &) {
+                count++;
+                return true;
+            }));
+        }
+        QCOMPARE(count, frames);
+    }
+
+    void exportFrames_data() {
+        QTest::addColumn<int>("frames");
+        QTest::addColumn<int>("format");
+        QTest::newRow("10k CSV") << 10000 << int(FrameExporter::CSV);
+        QTest::newRow("10k JSON Lines") << 10000 << int(FrameExporter::JSONLines);
+        QTest::newRow("100k CSV") << 100000 << int(FrameExporter::CSV);
+        QTest::newRow("100k JSON Lines") << 100000 << int(FrameExporter::JSONLines);
+    }
+
+    void exportFrames() {
+        QFETCH(int, frames);
+        QFETCH(int, format);
+        TomControl control(fakeTom(frames), false, nullptr);
+
+        FrameExporter::Options options;
+        options.format = static_cast<FrameExporter::Format>(format);
+        FrameExporter exporter(&control, options);
+
+        qint64 rows = 0;
+        QBENCHMARK {
+            QBuffer buffer;
+            buffer.open(QIODevice::WriteOnly);
+            QVERIFY(exporter.exportTo(&buffer, [&rows](qint64 written) {
+                rows = written;
+                return true;
+            }));
+        }
+        QCOMPARE(rows, qint64(frames));
+    }
+
+private:
+    void frameCounts() {
+        QTest::addColumn<int>("frames");
+        QTest::newRow("10k") << 10000;
+        QTest::newRow("100k") << 100000;
+    }
+
+    static QByteArray generateFrames(int count) {
+        const QDateTime &start = QDateTime(QDate(2018, 1, 1), QTime(8, 0));
+        QByteArray frames = "[";
+        for (int i = 0; i < count; i++) {
+            const QDateTime &frameStart = start.addSecs(i * 3600);
+            if (i > 0) {
+                frames += ",";
+            }
+            frames += QString(R"({"id":"frame-%1","projectID":"project-%2","startTime":"%3","stopTime":"%4","lastUpdated":"%4","archived":false,"notes":"notes, of frame %1"})")
+                    .arg(i)
+                    .arg(i % 100)
+                    .arg(frameStart.toString(Qt::ISODate))
+                    .arg(frameStart.addSecs(1800).toString(Qt::ISODate))
+                    .toUtf8();
+        }
+        frames += "]";
+        return frames;
+    }
+
+    /**
+     * @return The path of a script which prints the given number of frames, whatever the arguments are.
+     */
+    QString fakeTom(int frames) {
+        const QString &jsonFile = _dir.filePath(QString("frames-%1.json").arg(frames));
+        const QString &script = _dir.filePath(QString("tom-%1").arg(frames));
+        if (!QFile::exists(script)) {
+            QFile json(jsonFile);
+            if (json.open(QIODevice::WriteOnly)) {
+                json.write(generateFrames(frames));
+            }
+
+            QFile file(script);
+            if (file.open(QIODevice::WriteOnly)) {
+                file.write(QString("#!/bin/sh\ncat '%1'\n").arg(jsonFile).toUtf8());
+                file.close();
+                file.setPermissions(file.permissions() | QFileDevice::ExeOwner);
+            }
+        }
+        return script;
+    }
+
+    QTemporaryDir _dir;
+};
+
+QTEST_MAIN(FrameStreamBenchmark)
+
+#include "FrameStreamBenchmark.moc"
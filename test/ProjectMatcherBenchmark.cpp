@@ -0,0 +1,97 @@
+#include <QtTest/QtTest>
+
+#include "model/ProjectMatcher.h"
+
+/**
+ * Matches queries against generated names of clients, projects and tasks. A fresh query scans all names, a refined
+ * query is typed character by character and each character only checks the matches of the previous query.
+ */
+class ProjectMatcherBenchmark : public QObject {
+Q_OBJECT
+
+private slots:
+
+    void initTestCase() {
+        const QList<Project> &projects = generateProjects(PROJECT_COUNT);
+        _matcher.reset(projects);
+
+        QStringList recent;
+        for (int i = 0; i < 10; i++) {
+            recent << projects.at(i * 97).getID();
+        }
+        _matcher.setRecentProjectIDs(recent);
+    }
+
+    void fresh_data() {
+        queries();
+    }
+
+    void fresh() {
+        QFETCH(QString, query);
+
+        QVector<ProjectMatcher::Match> matches;
+        QBENCHMARK {
+            // the empty query discards the previous matches
+            _matcher.match(QString());
+            matches = _matcher.match(query);
+        }
+        QVERIFY(!matches.isEmpty());
+    }
+
+    void refined_data() {
+        queries();
+    }
+
+    void refined() {
+        QFETCH(QString, query);
+
+        QVector<ProjectMatcher::Match> matches;
+        QBENCHMARK {
+            _matcher.match(QString());
+            for (int length = 1; length <= query.length(); length++) {
+                matches = _matcher.match(query.left(length));
+            }
+        }
+        QVERIFY(!matches.isEmpty());
+    }
+
+private:
+    static const int PROJECT_COUNT = 50000;
+
+    static void queries() {
+        QTest::addColumn<QString>("query");
+        QTest::newRow("abbreviation") << "c12p3t4";
+        QTest::newRow("last segment") << "task 7";
+        QTest::newRow("spaced") << "client 4 project 9";
+    }
+
+    /**
+     * @return Clients with 10 projects, each project has 9 tasks.
+     */
+    static QList<Project> generateProjects(int count) {
+        QList<Project> projects;
+        for (int client = 0; projects.size() < count; client++) {
+            const QString &clientName = QString("client %1").arg(client);
+            const QString &clientID = QString("c%1").arg(client);
+            projects << Project(QStringList() << clientName, clientID, "", "", UNDEFINED, false);
+
+            for (int project = 0; project < 10 && projects.size() < count; project++) {
+                const QString &projectName = QString("project %1").arg(project);
+                const QString &projectID = QString("%1-p%2").arg(clientID).arg(project);
+                projects << Project(QStringList() << clientName << projectName, projectID, clientID, "", UNDEFINED, false);
+
+                for (int task = 0; task < 9 && projects.size() < count; task++) {
+                    projects << Project(QStringList() << clientName << projectName << QString("task %1").arg(task),
+                                        QString("%1-t%2").arg(projectID).arg(task), projectID, "", UNDEFINED, false);
+                }
+            }
+        }
+        return projects;
+    }
+
+    ProjectMatcher _matcher;
+};
+
+QTEST_MAIN(ProjectMatcherBenchmark)
+
+#include "ProjectMatcherBenchmark.moc"
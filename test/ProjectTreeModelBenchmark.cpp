@@ -0,0 +1,98 @@
+#include <algorithm>
+
+#include <QtTest/QtTest>
+
+#include "gotime/ProjectStatusManager.h"
+#include "model/ProjectTreeModel.h"
+
+/**
+ * Builds the project tree from a generated hierarchy of clients, projects and tasks.
+ */
+class ProjectTreeModelBenchmark : public QObject {
+Q_OBJECT
+
+private slots:
+
+    void initTestCase() {
+        QStandardPaths::setTestModeEnabled(true);
+        QCoreApplication::setApplicationName("tom-ui-benchmark");
+
+        _control = new TomControl("", false, this);
+        _statusManager = new ProjectStatusManager(_control, this);
+    }
+
+    void build_data() {
+        projectCounts();
+    }
+
+    void build() {
+        QFETCH(int, projects);
+        _control->setStartupData(generateProjects(projects), TomStatus());
+
+        ProjectTreeModel model(_control, _statusManager, true, nullptr, false);
+        QBENCHMARK {
+            model.loadCachedProjects();
+        }
+        QVERIFY(model.rowCount(model.index(0, 0, QModelIndex())) > 0);
+    }
+
+    void buildAndMaterializeAll_data() {
+        projectCounts();
+    }
+
+    void buildAndMaterializeAll() {
+        QFETCH(int, projects);
+        const QList<Project> &generated = generateProjects(projects);
+        _control->setStartupData(generated, TomStatus());
+
+        ProjectTreeModel model(_control, _statusManager, true, nullptr, false);
+        QBENCHMARK {
+            model.loadCachedProjects();
+            for (const auto &project : generated) {
+                model.getProjectRow(project.getID());
+            }
+        }
+        QVERIFY(model.getProjectRow(generated.last().getID()).isValid());
+    }
+
+private:
+    void projectCounts() {
+        QTest::addColumn<int>("projects");
+        QTest::newRow("1k") << 1000;
+        QTest::newRow("20k") << 20000;
+    }
+
+    /**
+     * @return Clients with 10 projects, each project has 9 tasks.
+     */
+    static QList<Project> generateProjects(int count) {
+        QList<Project> projects;
+        for (int client = 0; projects.size() < count; client++) {
+            const QString &clientName = QString("client %1").arg(client);
+            const QString &clientID = QString("c%1").arg(client);
+            projects << Project(QStringList() << clientName, clientID, "", "", UNDEFINED, false);
+
+            for (int project = 0; project < 10 && projects.size() < count; project++) {
+                const QString &projectName = QString("project %1").arg(project);
+                const QString &projectID = QString("%1-p%2").arg(clientID).arg(project);
+                projects << Project(QStringList() << clientName << projectName, projectID, clientID, "", UNDEFINED, false);
+
+                for (int task = 0; task < 9 && projects.size() < count; task++) {
+                    projects << Project(QStringList() << clientName << projectName << QString("task %1").arg(task),
+                                        QString("%1-t%2").arg(projectID).arg(task), projectID, "", UNDEFINED, false);
+                }
+            }
+        }
+
+        // tom doesn't sort its output by name
+        std::reverse(projects.begin(), projects.end());
+        return projects;
+    }
+
+    TomControl *_control = nullptr;
+    ProjectStatusManager *_statusManager = nullptr;
+};
+
+QTEST_MAIN(ProjectTreeModelBenchmark)
+
+#include "ProjectTreeModelBenchmark.moc"
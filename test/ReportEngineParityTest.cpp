@@ -0,0 +1,214 @@
+#include <cmath>
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include "gotime/TomControl.h"
+#include "report/ReportEngine.h"
+
+/**
+ * Compares the totals of the native report engine with tom's totals of the same generated frames.
+ * Tom's report is only available as HTML, the reference totals are taken from tom's status command, which sums up
+ * the frames like the report command. The status doesn't round and has no date range, the rounded totals and the
+ * totals of date ranges are compared with the totals of the frames which were imported into tom.
+ * The test is skipped without tom, TOM_PATH overrides the lookup in PATH.
+ */
+class ReportEngineParityTest : public QObject {
+Q_OBJECT
+
+private slots:
+
+    void initTestCase() {
+        _tomPath = qEnvironmentVariable("TOM_PATH");
+        if (_tomPath.isEmpty()) {
+            _tomPath = QStandardPaths::findExecutable("tom");
+        }
+        if (_tomPath.isEmpty()) {
+            QSKIP("tom wasn't found, set TOM_PATH to run the test");
+        }
+
+        // the days of the frames must be the same in tom and in the test
+        qputenv("TZ", "UTC");
+    }
+
+    void projectTotals_data() {
+        QTest::addColumn<int>("projects");
+        QTest::addColumn<int>("frames");
+        QTest::newRow("few projects") << 3 << 200;
+        QTest::newRow("many projects") << 40 << 1000;
+    }
+
+    void projectTotals() {
+        QFETCH(int, projects);
+        QFETCH(int, frames);
+
+        QTemporaryDir home;
+        TomControl control(_tomPath, false, nullptr);
+        QVERIFY(importFrames(home, control, projects, frames));
+        const QList<Project> &loaded = control.loadProjects();
+        QCOMPARE(loaded.size(), projects);
+
+        // the archived frames are only part of the totals if they're included
+        control.archiveProjectFrames(loaded.first(), false);
+
+        for (const bool includeArchived : {false, true}) {
+            const ProjectsStatus &status = control.projectsStatus(ProjectStatus::OVERALL_ID, true, includeArchived);
+
+            for (const auto &project : loaded) {
+                ReportOptions options;
+                options.projectIDs << project.getID();
+                options.includeSubprojects = true;
+                options.includeArchived = includeArchived;
+
+                ReportEngine engine(&control, options);
+                QVERIFY(engine.loadFrames());
+                QCOMPARE(engine.totalMillis(true), status.get(project.getID()).allTotal.asMillis());
+            }
+
+            ReportOptions options;
+            options.includeArchived = includeArchived;
+
+            ReportEngine engine(&control, options);
+            QVERIFY(engine.loadFrames());
+            QCOMPARE(engine.totalMillis(true), status.get(ProjectStatus::OVERALL_ID).allTotal.asMillis());
+        }
+    }
+
+    void roundedTotals_data() {
+        QTest::addColumn<int>("mode");
+        QTest::addColumn<int>("minutes");
+        QTest::newRow("up to 15 minutes") << int(UP) << 15;
+        QTest::newRow("nearest 6 minutes") << int(NEAREST) << 6;
+        QTest::newRow("down to 30 minutes") << int(DOWN) << 30;
+    }
+
+    void roundedTotals() {
+        QFETCH(int, mode);
+        QFETCH(int, minutes);
+
+        QTemporaryDir home;
+        TomControl control(_tomPath, false, nullptr);
+        QVERIFY(importFrames(home, control, 5, 500));
+
+        ReportOptions options;
+        options.includeArchived = true;
+        options.frameRoundingMode = static_cast<TimeRoundingMode>(mode);
+        options.frameRoundingMinutes = minutes;
+
+        ReportEngine engine(&control, options);
+        QVERIFY(engine.loadFrames());
+
+        // each frame is rounded on its own
+        qint64 expected = 0;
+        for (const auto &frame : _frames) {
+            expected += rounded(frame.second - frame.first, options.frameRoundingMode, minutes);
+        }
+        QCOMPARE(engine.totalMillis(false), expected);
+    }
+
+    void dateRangeTotals_data() {
+        QTest::addColumn<QDate>("start");
+        QTest::addColumn<QDate>("end");
+        QTest::newRow("single day") << QDate(2019, 1, 10) << QDate(2019, 1, 10);
+        QTest::newRow("two weeks") << QDate(2019, 1, 7) << QDate(2019, 1, 20);
+        QTest::newRow("open start") << QDate() << QDate(2019, 1, 15);
+        QTest::newRow("open end") << QDate(2019, 2, 1) << QDate();
+    }
+
+    void dateRangeTotals() {
+        QFETCH(QDate, start);
+        QFETCH(QDate, end);
+
+        QTemporaryDir home;
+        TomControl control(_tomPath, false, nullptr);
+        QVERIFY(importFrames(home, control, 5, 500));
+
+        ReportOptions options;
+        options.includeArchived = true;
+        options.start = start;
+        options.end = end;
+
+        ReportEngine engine(&control, options);
+        QVERIFY(engine.loadFrames());
+
+        // frames belong to the day of their start, like in tom's reports
+        qint64 expected = 0;
+        for (const auto &frame : _frames) {
+            const QDate &day = QDateTime::fromSecsSinceEpoch(frame.first / 1000, Qt::UTC).date();
+            if ((!start.isValid() || day >= start) && (!end.isValid() || day <= end)) {
+                expected += frame.second - frame.first;
+            }
+        }
+        QVERIFY(expected > 0);
+        QCOMPARE(engine.totalMillis(true), expected);
+    }
+
+private:
+    /**
+     * Imports generated frames into a new data directory of tom. The frames are kept in _frames.
+     */
+    bool importFrames(const QTemporaryDir &home, TomControl &control, int projects, int frames) {
+        if (!home.isValid()) {
+            return false;
+        }
+
+        // tom keeps its data in the home directory, each dataset uses a new one
+        qputenv("HOME", home.path().toUtf8());
+        qputenv("XDG_CONFIG_HOME", home.filePath(".config").toUtf8());
+        qputenv("XDG_DATA_HOME", home.filePath(".local/share").toUtf8());
+
+        const QString &fileName = home.filePath("frames.json");
+        return writeWatsonFrames(fileName, projects, frames) && control.importWatsonFrames(fileName);
+    }
+
+    /**
+     * Writes frames in the format of Watson, which are imported by tom. Some frames span midnight.
+     */
+    bool writeWatsonFrames(const QString &fileName, int projects, int frames) {
+        qsrand(42);
+        const qint64 base = QDateTime(QDate(2019, 1, 1), QTime(8, 0), Qt::UTC).toSecsSinceEpoch();
+
+        _frames.clear();
+        QJsonArray array;
+        for (int i = 0; i < frames; i++) {
+            const qint64 start = base + i * 3 * 3600 + qrand() % 3600;
+            const qint64 stop = start + 60 * (5 + qrand() % 240);
+            _frames << qMakePair(start * 1000, stop * 1000);
+
+            QJsonArray frame;
+            frame << start << stop << QString("project %1").arg(i % projects)
+                  << QString("%1").arg(i, 32, 16, QChar('0')) << QJsonArray() << stop;
+            array << frame;
+        }
+
+        QFile file(fileName);
+        return file.open(QIODevice::WriteOnly) && file.write(QJsonDocument(array).toJson()) > 0;
+    }
+
+    /**
+     * @return The duration rounded to the steps, computed independently of roundedMillis().
+     */
+    static qint64 rounded(qint64 millis, TimeRoundingMode mode, int minutes) {
+        const qint64 step = qint64(minutes) * 60 * 1000;
+        const double steps = double(millis) / step;
+        switch (mode) {
+            case UP:
+                return qint64(std::ceil(steps)) * step;
+            case DOWN:
+                return qint64(std::floor(steps)) * step;
+            case NEAREST:
+                return qint64(std::floor(steps + 0.5)) * step;
+            case NONE:
+                break;
+        }
+        return millis;
+    }
+
+    QString _tomPath;
+    // the start and the stop of the generated frames in milliseconds
+    QList<QPair<qint64, qint64>> _frames;
+};
+
+QTEST_MAIN(ReportEngineParityTest)
+
+#include "ReportEngineParityTest.moc"
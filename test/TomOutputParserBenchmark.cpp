@@ -0,0 +1,113 @@
+#include <QtCore/QThreadPool>
+#include <QtTest/QtTest>
+
+#include "gotime/TomOutputParser.h"
+
+static const int FRAME_COUNT = 200000;
+static const int PROJECT_COUNT = 50000;
+
+/**
+ * Parses generated outputs of tom's frames, projects and status commands with an increasing number of threads.
+ * The speedup is the time of the row with a single thread divided by the time of the other rows.
+ */
+class TomOutputParserBenchmark : public QObject {
+Q_OBJECT
+
+private slots:
+
+    void initTestCase() {
+        _maxThreads = QThreadPool::globalInstance()->maxThreadCount();
+
+        const QDateTime &start = QDateTime(QDate(2018, 1, 1), QTime(8, 0));
+        QByteArray frames = "[";
+        for (int i = 0; i < FRAME_COUNT; i++) {
+            const QDateTime &frameStart = start.addSecs(i * 3600);
+            if (i > 0) {
+                frames += ",";
+            }
+            frames += QString(R"({"id":"frame-%1","projectID":"project-%2","startTime":"%3","stopTime":"%4","lastUpdated":"%4","archived":%5,"notes":"notes of frame %1"})")
+                    .arg(i)
+                    .arg(i % PROJECT_COUNT)
+                    .arg(frameStart.toString(Qt::ISODate))
+                    .arg(frameStart.addSecs(1800).toString(Qt::ISODate))
+                    .arg(i % 10 == 0 ? "true" : "false")
+                    .toUtf8();
+        }
+        frames += "]";
+        _frames = frames;
+
+        for (int i = 0; i < PROJECT_COUNT; i++) {
+            _projects += QString("client %1||project %2\tproject-%2\tclient-%1\t\t\tfalse\n").arg(i / 10).arg(i);
+            _status += QString("project-%1\t1\t2\t3\t4\t5\t6\t7\t8\t9\t10\t11\t12\n").arg(i);
+        }
+    }
+
+    void cleanupTestCase() {
+        QThreadPool::globalInstance()->setMaxThreadCount(_maxThreads);
+    }
+
+    void parseFrames_data() {
+        threadCounts();
+    }
+
+    void parseFrames() {
+        QFETCH(int, threads);
+        QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+        int count = 0;
+        QBENCHMARK {
+            const QList<Frame *> &frames = TomOutputParser::parseFrames(_frames);
+            count = frames.size();
+            qDeleteAll(frames);
+        }
+        QCOMPARE(count, FRAME_COUNT);
+    }
+
+    void parseProjects_data() {
+        threadCounts();
+    }
+
+    void parseProjects() {
+        QFETCH(int, threads);
+        QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+        int count = 0;
+        QBENCHMARK {
+            count = TomOutputParser::parseProjects(_projects).size();
+        }
+        QCOMPARE(count, PROJECT_COUNT);
+    }
+
+    void parseProjectsStatus_data() {
+        threadCounts();
+    }
+
+    void parseProjectsStatus() {
+        QFETCH(int, threads);
+        QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+        int count = 0;
+        QBENCHMARK {
+            count = TomOutputParser::parseProjectsStatus(_status, 13).size();
+        }
+        QCOMPARE(count, PROJECT_COUNT);
+    }
+
+private:
+    void threadCounts() {
+        QTest::addColumn<int>("threads");
+        for (int threads = 1; threads < _maxThreads; threads *= 2) {
+            QTest::newRow(qPrintable(QString("%1 threads").arg(threads))) << threads;
+        }
+        QTest::newRow(qPrintable(QString("%1 threads").arg(_maxThreads))) << _maxThreads;
+    }
+
+    int _maxThreads = 1;
+    QByteArray _frames;
+    QString _projects;
+    QString _status;
+};
+
+QTEST_MAIN(TomOutputParserBenchmark)
+
+#include "TomOutputParserBenchmark.moc"
@@ -1039,12 +1039,20 @@
         <source>Project: &lt;strong&gt;%1&lt;/strong&gt;&lt;br&gt;Notes are required to stop the current time entry.</source>
         <translation type="unfinished"></translation>
     </message>
+    <message numerus="yes">
+        <location filename="../source/main_window.cpp" line="534"/>
+        <source>%n entries, total: %1 / %2, min: %3, max: %4</source>
+        <comment>statusbar</comment>
+        <translation>
+            <numerusform>%n Eintrag, gesamt: %1 / %2, min.: %3, max.: %4</numerusform>
+            <numerusform>%n Einträge, gesamt: %1 / %2, min.: %3, max.: %4</numerusform>
+        </translation>
+    </message>
     <message>
-        <location filename="../deployment/src/tom-ui/source/main_window.cpp" line="396"/>
-        <location filename="../source/main_window.cpp" line="397"/>
-        <source>Total: %1 / %2</source>
+        <location filename="../source/main_window.cpp" line="542"/>
+        <source>, earnings: %1</source>
         <comment>statusbar</comment>
-        <translation>Gesamt: %1 / %2</translation>
+        <translation>, Umsatz: %1</translation>
     </message>
     <message>
         <location filename="../deployment/src/tom-ui/source/main_window.ui" line="73"/>